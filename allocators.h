@@ -0,0 +1,511 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(VECTOR_USE_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace vector_detail {
+
+// Выровненный operator new. Без исключений нехватка памяти передаётся ReportVectorError
+inline void* AlignedNew(size_t bytes, size_t alignment) {
+#if VECTOR_EXCEPTIONS
+    return operator new(bytes, std::align_val_t{alignment});
+#else
+    void* p = operator new(bytes, std::align_val_t{alignment}, std::nothrow);
+    if (p == nullptr) {
+        ReportVectorError(VectorError::BAD_ALLOC, "out of memory");
+    }
+    return p;
+#endif
+}
+
+}  // namespace vector_detail
+
+// Аллокатор, выравнивающий каждый блок по границе Alignment байт (по умолчанию 64 — размер
+// кеш-линии и ширина регистра AVX-512). Память выделяется выровненным operator new
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator {
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment is weaker than alignof(T)");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::BAD_ARRAY_NEW_LENGTH, "allocation size overflows size_t");
+        }
+        return static_cast<T*>(vector_detail::AlignedNew(n * sizeof(T), Alignment));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+// Аллокатор для больших векторов. Блоки не меньше ThresholdBytes отображаются через mmap
+// с размером, кратным 2 МиБ, и помечаются MADV_HUGEPAGE, чтобы ядро подкрепило их огромными
+// страницами и сократило промахи TLB. Меньшие блоки выделяются как в AlignedAllocator.
+// Метод reallocate расширяет отображённый блок через mremap без копирования элементов,
+// поэтому Vector тривиально перемещаемых типов растёт без переноса данных.
+// На системах без mmap/mremap все блоки выделяются выровненным operator new
+template <typename T, size_t Alignment = 64, size_t ThresholdBytes = (size_t{2} << 20)>
+class HugePageAllocator {
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment is weaker than alignof(T)");
+    static_assert(Alignment <= 4096, "mmap only guarantees page alignment");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Alignment, ThresholdBytes>;
+    };
+
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment, ThresholdBytes>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::BAD_ARRAY_NEW_LENGTH, "allocation size overflows size_t");
+        }
+        const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (IsMapped(bytes)) {
+            void* p = mmap(nullptr, MappedSize(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                ReportVectorError(VectorError::BAD_ALLOC, "HugePageAllocator: mmap failed");
+            }
+            Advise(p, MappedSize(bytes));
+            return static_cast<T*>(p);
+        }
+#endif
+        return static_cast<T*>(vector_detail::AlignedNew(bytes, Alignment));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+#if defined(__linux__)
+        if (IsMapped(n * sizeof(T))) {
+            munmap(p, MappedSize(n * sizeof(T)));
+            return;
+        }
+#endif
+        operator delete(p, std::align_val_t{Alignment});
+    }
+
+    // Расширяет или сужает отображённый блок, сохраняя содержимое. Для блоков, выделенных
+    // через operator new, возвращает nullptr: вектор перенесёт элементы сам
+    T* reallocate([[maybe_unused]] T* p, [[maybe_unused]] size_t old_n, [[maybe_unused]] size_t new_n) noexcept {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        const size_t old_bytes = old_n * sizeof(T);
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return nullptr;
+        }
+        const size_t new_bytes = new_n * sizeof(T);
+        if (!IsMapped(old_bytes) || !IsMapped(new_bytes)) {
+            return nullptr;
+        }
+        void* result = mremap(p, MappedSize(old_bytes), MappedSize(new_bytes), MREMAP_MAYMOVE);
+        if (result == MAP_FAILED) {
+            return nullptr;
+        }
+        Advise(result, MappedSize(new_bytes));
+        return static_cast<T*>(result);
+#else
+        return nullptr;
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, Alignment, ThresholdBytes>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U, Alignment, ThresholdBytes>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr bool IsMapped(size_t bytes) noexcept {
+        return bytes >= ThresholdBytes;
+    }
+
+    static constexpr size_t MappedSize(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+#if defined(__linux__)
+    static void Advise([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) noexcept {
+#if defined(MADV_HUGEPAGE)
+        // Подсказка необязательна: при выключенных transparent huge pages вызов просто не действует
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    }
+#endif
+};
+
+// Аллокатор поверх malloc/realloc/free. Сообщает вектору фактический размер блока
+// (allocate_at_least по malloc_usable_size либо sallocx из jemalloc), чтобы запас, который
+// malloc всё равно выделил, стал вместимостью. Рост тривиально перемещаемых векторов выполняется
+// через realloc, который часто расширяет блок на месте. try_expand, расширяющий блок без
+// перемещения для любых типов, есть только с jemalloc (xallocx): у glibc нет способа расширить
+// блок, не перемещая его, а запас блока уже учтён allocate_at_least.
+// Для jemalloc определите VECTOR_USE_JEMALLOC. Выравнивание ограничено alignof(std::max_align_t)
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not guarantee stricter alignment");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = MallocAllocator<U>;
+    };
+
+    struct AllocationResult {
+        T* ptr;
+        size_t count;
+    };
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult allocate_at_least(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::BAD_ARRAY_NEW_LENGTH, "allocation size overflows size_t");
+        }
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            ReportVectorError(VectorError::BAD_ALLOC, "MallocAllocator: malloc failed");
+        }
+        return {static_cast<T*>(p), std::max(n, UsableBytes(p) / sizeof(T))};
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    // Меняет размер блока через realloc. При неудаче возвращает nullptr, блок p не меняется
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) noexcept {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return nullptr;
+        }
+        return static_cast<T*>(std::realloc(p, new_n * sizeof(T)));
+    }
+
+#if defined(VECTOR_USE_JEMALLOC)
+    // Расширяет блок без перемещения, если за ним есть свободное место
+    bool try_expand(T* p, size_t /*old_n*/, size_t new_n) noexcept {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return false;
+        }
+        return xallocx(p, new_n * sizeof(T), 0, 0) >= new_n * sizeof(T);
+    }
+#endif
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    // Фактический размер блока, выделенного malloc, либо 0, если платформа его не сообщает
+    static size_t UsableBytes([[maybe_unused]] void* p) noexcept {
+#if defined(VECTOR_USE_JEMALLOC)
+        return sallocx(p, 0);
+#elif defined(__GLIBC__)
+        return malloc_usable_size(p);
+#else
+        return 0;
+#endif
+    }
+};
+
+// Кеш освобождённых блоков памяти текущего потока, из которого RecyclingAllocator выдаёт буферы.
+// Блоки разбиты на классы размеров — степени двойки от MIN_BLOCK_BYTES до MAX_BLOCK_BYTES; в классе
+// хранится не больше BLOCKS_PER_CLASS блоков, а всего — не больше бюджета потока (SetBudget).
+// Блок, освобождённый другим потоком, попадает в кеш освобождающего потока. Кеш потока
+// освобождается при его завершении. Попадания и промахи учитывает VectorStats
+class RecyclingCache {
+public:
+    static constexpr size_t MIN_BLOCK_BYTES = 64;
+    static constexpr size_t MAX_BLOCK_BYTES = size_t{1} << 20;
+    static constexpr size_t BLOCKS_PER_CLASS = 8;
+    static constexpr size_t DEFAULT_BUDGET_BYTES = size_t{4} << 20;
+    static constexpr size_t ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    // Размер блока класса, в который попадает запрос bytes, либо 0, если запрос кешировать не нужно
+    static constexpr size_t BlockBytes(size_t bytes) noexcept {
+        if (bytes <= MIN_BLOCK_BYTES) {
+            return MIN_BLOCK_BYTES;
+        }
+        if (bytes > MAX_BLOCK_BYTES) {
+            return 0;
+        }
+        return size_t{1} << (vector_detail::HighestBit(bytes - 1) + 1);
+    }
+
+    // Блок размера block_bytes (значение BlockBytes): из кеша потока, а если он пуст — из кучи
+    static void* Allocate(size_t block_bytes) {
+        State& state = Local();
+        const size_t index = ClassIndex(block_bytes);
+        if (state.counts[index] != 0) {
+            state.cached_bytes -= block_bytes;
+            VectorStats::RecordRecycleHit();
+            return state.blocks[index][--state.counts[index]];
+        }
+        VectorStats::RecordRecycleMiss();
+        return vector_detail::AlignedNew(block_bytes, ALIGNMENT);
+    }
+
+    // Сохраняет блок в кеше потока. Если класс заполнен, бюджет исчерпан или поток уже
+    // завершается, блок возвращается в кучу
+    static void Deallocate(void* block, size_t block_bytes) noexcept {
+        State& state = Local();
+        const size_t index = ClassIndex(block_bytes);
+        if (state.finished || state.counts[index] == BLOCKS_PER_CLASS ||
+            block_bytes > state.budget - std::min(state.budget, state.cached_bytes)) {
+            operator delete(block, std::align_val_t{ALIGNMENT});
+            return;
+        }
+        if (!state.reaper_registered) {
+            RegisterReaper();
+        }
+        state.blocks[index][state.counts[index]++] = block;
+        state.cached_bytes += block_bytes;
+    }
+
+    // Возвращает в кучу все блоки кеша текущего потока
+    static void Trim() noexcept {
+        State& state = Local();
+        for (size_t index = 0; index < CLASSES; ++index) {
+            while (state.counts[index] != 0) {
+                operator delete(state.blocks[index][--state.counts[index]], std::align_val_t{ALIGNMENT});
+            }
+        }
+        state.cached_bytes = 0;
+    }
+
+    // Наибольший суммарный размер блоков в кеше текущего потока; 0 отключает кеширование.
+    // Если кеш уже больше бюджета, он очищается
+    static void SetBudget(size_t bytes) noexcept {
+        Local().budget = bytes;
+        if (Local().cached_bytes > bytes) {
+            Trim();
+        }
+    }
+
+    // Суммарный размер блоков в кеше текущего потока
+    static size_t CachedBytes() noexcept {
+        return Local().cached_bytes;
+    }
+
+private:
+    static constexpr size_t CLASSES =
+        vector_detail::HighestBit(MAX_BLOCK_BYTES) - vector_detail::HighestBit(MIN_BLOCK_BYTES) + 1;
+
+    // Тривиально разрушаемо и инициализируется константой: доступно без проверок инициализации
+    // и в деструкторах других thread_local-объектов
+    struct State {
+        void* blocks[CLASSES][BLOCKS_PER_CLASS];
+        size_t counts[CLASSES];
+        size_t cached_bytes;
+        size_t budget;
+        bool reaper_registered;
+        bool finished;
+    };
+
+    // Очищает кеш при завершении потока. Регистрируется при первом сохранении блока, поэтому
+    // thread_local-объекты, созданные раньше, разрушаются после него и освобождают память напрямую
+    struct Reaper {
+        ~Reaper() {
+            Trim();
+            Local().finished = true;
+        }
+    };
+
+    static State& Local() noexcept {
+        thread_local State state{{}, {}, 0, DEFAULT_BUDGET_BYTES, false, false};
+        return state;
+    }
+
+    static void RegisterReaper() noexcept {
+        thread_local Reaper reaper;
+        Local().reaper_registered = true;
+    }
+
+    static size_t ClassIndex(size_t block_bytes) noexcept {
+        assert(BlockBytes(block_bytes) == block_bytes && "RecyclingCache: not a block size");
+        return vector_detail::HighestBit(block_bytes) - vector_detail::HighestBit(MIN_BLOCK_BYTES);
+    }
+};
+
+// Аллокатор для векторов, которые многократно создаются, растут до похожего размера и разрушаются
+// (обработчики запросов). Буферы до RecyclingCache::MAX_BLOCK_BYTES берутся из кеша потока
+// и возвращаются в него, минуя кучу, а allocate_at_least сообщает вместимостью весь блок класса.
+// Большие буферы выделяются выровненным operator new напрямую. Выравнивание ограничено
+// RecyclingCache::ALIGNMENT
+template <typename T>
+class RecyclingAllocator {
+    static_assert(alignof(T) <= RecyclingCache::ALIGNMENT, "RecyclingCache does not guarantee stricter alignment");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = RecyclingAllocator<U>;
+    };
+
+    struct AllocationResult {
+        T* ptr;
+        size_t count;
+    };
+
+    RecyclingAllocator() = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult allocate_at_least(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::BAD_ARRAY_NEW_LENGTH, "allocation size overflows size_t");
+        }
+        const size_t block = RecyclingCache::BlockBytes(n * sizeof(T));
+        if (block == 0) {
+            return {static_cast<T*>(vector_detail::AlignedNew(n * sizeof(T), RecyclingCache::ALIGNMENT)), n};
+        }
+        return {static_cast<T*>(RecyclingCache::Allocate(block)), block / sizeof(T)};
+    }
+
+    // n — вместимость, сообщённая allocate_at_least, либо размер запроса allocate: оба дают тот же класс
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t block = RecyclingCache::BlockBytes(n * sizeof(T));
+        if (block == 0) {
+            operator delete(p, std::align_val_t{RecyclingCache::ALIGNMENT});
+        } else {
+            RecyclingCache::Deallocate(p, block);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const RecyclingAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const RecyclingAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+template <typename T>
+using RecyclingVector = Vector<T, RecyclingAllocator<T>>;
+
+// Вместимость, выученная для одного места создания векторов: рост итогового размера принимается
+// сразу, уменьшение — на 1/8 разницы за наблюдение, поэтому единичный маленький запрос подсказку
+// не сбрасывает. Может использоваться из нескольких потоков; одновременные обновления
+// не синхронизируются, и одно из них может потеряться
+class CapacityHint {
+public:
+    size_t Capacity() const noexcept {
+        return capacity_.load(std::memory_order_relaxed);
+    }
+
+    // Учитывает итоговый размер очередного вектора
+    void Learn(size_t final_size) noexcept {
+        const size_t current = Capacity();
+        const size_t next = final_size >= current ? final_size : current - (current - final_size) / 8;
+        capacity_.store(next, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> capacity_{0};
+};
+
+// Время жизни вектора на месте вызова: при создании резервирует вместимость из подсказки
+// (одна аллокация вместо лестницы 1, 2, 4, ...), при разрушении сообщает подсказке итоговый размер
+template <typename Vec>
+class CapacityHintScope {
+public:
+    CapacityHintScope(CapacityHint& hint, Vec& vector)
+        : hint_(hint)
+        , vector_(vector) {
+        vector_.Reserve(hint_.Capacity());
+    }
+
+    CapacityHintScope(const CapacityHintScope&) = delete;
+    CapacityHintScope& operator=(const CapacityHintScope&) = delete;
+
+    ~CapacityHintScope() {
+        hint_.Learn(vector_.Size());
+    }
+
+private:
+    CapacityHint& hint_;
+    Vec& vector_;
+};
+
+// Подсказка, своя для каждого места в коде, где записан макрос:
+//     RecyclingVector<Item> items;
+//     CapacityHintScope scope(VECTOR_CAPACITY_HINT(), items);
+#define VECTOR_CAPACITY_HINT() ([]() -> CapacityHint& { static CapacityHint hint; return hint; }())
@@ -0,0 +1,583 @@
+// Сравнение производительности Vector и std::vector.
+// Для каждого сценария и типа элементов печатаются время, число выделений памяти
+// и объём выделенной памяти в пересчёте на одну операцию, а также отношение времени
+// Vector к std::vector (меньше 1 — Vector быстрее).
+//
+// Запуск: benchmark [фильтр] [--min-time=секунды]
+// Фильтр — подстрока имени сценария или типа, например «insert» или «string».
+// В сборке с VECTOR_ENABLE_STATS в конце печатаются счётчики VectorStats.
+
+#include "vector.h"
+#include "allocators.h"
+#include "flat_map.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Счётчики глобальных выделений памяти
+struct AllocationCounters {
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+AllocationCounters g_allocations;
+
+void* CountedAllocate(size_t size) {
+    ++g_allocations.allocations;
+    g_allocations.bytes += size;
+    if (void* p = std::malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* CountedAllocate(size_t size, std::align_val_t alignment) {
+    ++g_allocations.allocations;
+    g_allocations.bytes += size;
+    const size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size) {
+    return CountedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t /*alignment*/) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// 64-байтная POD-запись
+struct Pod64 {
+    std::uint64_t key;
+    std::uint64_t payload[7];
+
+    bool operator<(const Pod64& other) const noexcept {
+        return key < other.key;
+    }
+};
+
+static_assert(sizeof(Pod64) == 64);
+
+// Тип с перемещением, которое может выбрасывать исключения: контейнеры вынуждены копировать
+// такие элементы при реаллокации, чтобы сохранить строгую гарантию
+struct ThrowingMove {
+    explicit ThrowingMove(int value)
+        : value(value)
+        , text(32, 'x') {
+    }
+
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : value(other.value)
+        , text(std::move(other.text)) {
+    }
+
+    ThrowingMove& operator=(ThrowingMove&& other) noexcept(false) {
+        value = other.value;
+        text = std::move(other.text);
+        return *this;
+    }
+
+    bool operator<(const ThrowingMove& other) const noexcept {
+        return value < other.value;
+    }
+
+    int value;
+    std::string text;
+};
+
+template <typename T>
+T MakeValue(size_t i);
+
+template <>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i * 2654435761u);
+}
+
+template <>
+Pod64 MakeValue<Pod64>(size_t i) {
+    Pod64 pod{};
+    pod.key = i * 11400714819323198485ull;
+    return pod;
+}
+
+template <>
+std::string MakeValue<std::string>(size_t i) {
+    // Часть строк помещается в SSO-буфер, часть требует выделения памяти
+    return std::string(i % 3 == 0 ? 40 : 8, static_cast<char>('a' + i % 26));
+}
+
+template <>
+ThrowingMove MakeValue<ThrowingMove>(size_t i) {
+    return ThrowingMove(static_cast<int>(i * 2654435761u));
+}
+
+// Единый интерфейс к Vector и std::vector
+template <typename T>
+void PushBack(Vector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void PushBack(std::vector<T>& v, const T& value) {
+    v.push_back(value);
+}
+
+template <typename T>
+void EmplaceBack(Vector<T>& v, T&& value) {
+    v.EmplaceBack(std::move(value));
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v, T&& value) {
+    v.emplace_back(std::move(value));
+}
+
+template <typename T>
+void Reserve(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void Reserve(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+
+template <typename T>
+void InsertAt(Vector<T>& v, size_t index, const T& value) {
+    v.Insert(v.begin() + index, value);
+}
+
+template <typename T>
+void InsertAt(std::vector<T>& v, size_t index, const T& value) {
+    v.insert(v.begin() + index, value);
+}
+
+template <typename T>
+void EraseAt(Vector<T>& v, size_t index) {
+    v.Erase(v.begin() + index);
+}
+
+template <typename T>
+void EraseAt(std::vector<T>& v, size_t index) {
+    v.erase(v.begin() + index);
+}
+
+template <typename T>
+size_t SizeOf(const Vector<T>& v) {
+    return v.Size();
+}
+
+template <typename T>
+size_t SizeOf(const std::vector<T>& v) {
+    return v.size();
+}
+
+template <typename T>
+bool Contains(const FlatSet<T>& set, const T& value) {
+    return set.Contains(value);
+}
+
+template <typename T>
+bool Contains(const std::set<T>& set, const T& value) {
+    return set.count(value) != 0;
+}
+
+template <typename Container, typename T>
+Container MakeContainer(size_t size) {
+    Container c;
+    Reserve(c, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(c, MakeValue<T>(i));
+    }
+    return c;
+}
+
+// Не даёт компилятору выбросить вычисление
+template <typename T>
+void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+size_t Checksum(int value) {
+    return static_cast<size_t>(value);
+}
+
+size_t Checksum(const Pod64& value) {
+    return value.key;
+}
+
+size_t Checksum(const std::string& value) {
+    return value.size();
+}
+
+size_t Checksum(const ThrowingMove& value) {
+    return static_cast<size_t>(value.value);
+}
+
+struct Measurement {
+    double ns_per_op = 0;
+    double allocations_per_op = 0;
+    double bytes_per_op = 0;
+};
+
+struct BenchmarkConfig {
+    double min_time_seconds = 0.1;
+    std::string_view filter;
+};
+
+// Тело замера и необязательная подготовка, которая выполняется перед каждым вызовом тела
+// вне замера: её время и выделения памяти не учитываются. Подготовка нужна сценариям, которым
+// каждый раз требуется свежее состояние, которое тело не может восстановить само
+struct Scenario {
+    Scenario(std::function<size_t()> body, std::function<void()> prepare = {})
+        : body(std::move(body))
+        , prepare(std::move(prepare)) {
+    }
+
+    std::function<size_t()> body;
+    std::function<void()> prepare;
+};
+
+// Выполняет тело, пока суммарное время его вызовов не превысит min_time. Тело возвращает число
+// выполненных операций; подготовка внутри тела попадает в замер, поэтому сценарии выносят её
+// за пределы тела или в Scenario::prepare
+Measurement Measure(const BenchmarkConfig& config, const Scenario& scenario) {
+    using Clock = std::chrono::steady_clock;
+    if (scenario.prepare) {
+        scenario.prepare();
+    }
+    scenario.body();  // Прогрев
+
+    size_t total_ops = 0;
+    AllocationCounters measured;
+    std::chrono::duration<double> elapsed{};
+    do {
+        if (scenario.prepare) {
+            scenario.prepare();
+        }
+        const AllocationCounters before = g_allocations;
+        const auto start = Clock::now();
+        total_ops += scenario.body();
+        elapsed += Clock::now() - start;
+        measured.allocations += g_allocations.allocations - before.allocations;
+        measured.bytes += g_allocations.bytes - before.bytes;
+    } while (elapsed.count() < config.min_time_seconds);
+
+    Measurement result;
+    result.ns_per_op = elapsed.count() * 1e9 / static_cast<double>(total_ops);
+    result.allocations_per_op = static_cast<double>(measured.allocations) / total_ops;
+    result.bytes_per_op = static_cast<double>(measured.bytes) / total_ops;
+    return result;
+}
+
+// Сценарии. Каждый возвращает тело замера для контейнера Container с элементами T
+constexpr size_t GROWTH_SIZE = 100'000;
+constexpr size_t SHIFT_SIZE = 2'000;
+constexpr size_t LOOKUP_SIZE = 10'000;
+constexpr size_t REQUEST_SIZE = 1'000;
+constexpr size_t REQUESTS = 100;
+
+template <typename Container, typename T>
+std::function<size_t()> PushBackGrowth() {
+    return [] {
+        Container c;
+        for (size_t i = 0; i < GROWTH_SIZE; ++i) {
+            PushBack(c, MakeValue<T>(i));
+        }
+        DoNotOptimize(c);
+        return GROWTH_SIZE;
+    };
+}
+
+template <typename Container, typename T>
+std::function<size_t()> EmplaceBackGrowth() {
+    return [] {
+        Container c;
+        for (size_t i = 0; i < GROWTH_SIZE; ++i) {
+            EmplaceBack(c, MakeValue<T>(i));
+        }
+        DoNotOptimize(c);
+        return GROWTH_SIZE;
+    };
+}
+
+template <typename Container, typename T>
+std::function<size_t()> ReserveFill() {
+    return [] {
+        Container c;
+        Reserve(c, GROWTH_SIZE);
+        for (size_t i = 0; i < GROWTH_SIZE; ++i) {
+            PushBack(c, MakeValue<T>(i));
+        }
+        DoNotOptimize(c);
+        return GROWTH_SIZE;
+    };
+}
+
+template <typename Container, typename T>
+std::function<size_t()> InsertMiddle() {
+    return [] {
+        Container c = MakeContainer<Container, T>(SHIFT_SIZE);
+        const T value = MakeValue<T>(0);
+        for (size_t i = 0; i < SHIFT_SIZE; ++i) {
+            InsertAt(c, SizeOf(c) / 2, value);
+        }
+        DoNotOptimize(c);
+        return SHIFT_SIZE;
+    };
+}
+
+template <typename Container, typename T>
+std::function<size_t()> EraseMiddle() {
+    return [] {
+        Container c = MakeContainer<Container, T>(SHIFT_SIZE * 2);
+        for (size_t i = 0; i < SHIFT_SIZE; ++i) {
+            EraseAt(c, SizeOf(c) / 2);
+        }
+        DoNotOptimize(c);
+        return SHIFT_SIZE;
+    };
+}
+
+// Копирующее присваивание с переиспользованием буфера: вектор из target_size элементов получает
+// GROWTH_SIZE элементов и затем возвращается к исходному содержимому. При target_size == GROWTH_SIZE
+// оба присваивания одинакового размера, при большем target_size — уменьшение с разрушением хвоста
+// и обратный рост в пределах вместимости
+template <typename Container, typename T>
+std::function<size_t()> CopyAssign(size_t target_size) {
+    auto source = std::make_shared<Container>(MakeContainer<Container, T>(GROWTH_SIZE));
+    auto original = std::make_shared<Container>(MakeContainer<Container, T>(target_size));
+    auto target = std::make_shared<Container>(*original);
+    return [source, original, target, target_size] {
+        *target = *source;
+        DoNotOptimize(*target);
+        *target = *original;
+        DoNotOptimize(*target);
+        return GROWTH_SIZE + target_size;
+    };
+}
+
+// Присваивание в вектор меньшей вместимости, поэтому присваивание выделяет новый буфер.
+// Целевой вектор из GROWTH_SIZE / 4 элементов строится заново вне замера
+template <typename Container, typename T>
+Scenario CopyAssignGrow() {
+    auto source = std::make_shared<Container>(MakeContainer<Container, T>(GROWTH_SIZE));
+    auto target = std::make_shared<Container>();
+    return Scenario(
+        [source, target] {
+            *target = *source;
+            DoNotOptimize(*target);
+            return GROWTH_SIZE;
+        },
+        [target] {
+            *target = MakeContainer<Container, T>(GROWTH_SIZE / 4);
+        });
+}
+
+template <typename Container, typename T>
+std::function<size_t()> Iterate() {
+    auto source = std::make_shared<Container>(MakeContainer<Container, T>(GROWTH_SIZE));
+    return [source] {
+        size_t sum = 0;
+        for (const T& value : *source) {
+            sum += Checksum(value);
+        }
+        DoNotOptimize(sum);
+        return GROWTH_SIZE;
+    };
+}
+
+template <typename Container, typename T>
+std::function<size_t()> Sort() {
+    auto source = std::make_shared<Container>(MakeContainer<Container, T>(GROWTH_SIZE / 10));
+    auto target = std::make_shared<Container>();
+    return [source, target] {
+        *target = *source;
+        std::sort(target->begin(), target->end());
+        DoNotOptimize(*target);
+        return GROWTH_SIZE / 10;
+    };
+}
+
+// Поиск в упорядоченном множестве: FlatSet сравнивается с std::set. Половина запросов
+// попадает мимо множества
+template <typename Set, typename T>
+std::function<size_t()> Lookup() {
+    std::vector<T> keys;
+    for (size_t i = 0; i < LOOKUP_SIZE; ++i) {
+        keys.push_back(MakeValue<T>(i * 2));
+    }
+    auto set = std::make_shared<Set>(keys.begin(), keys.end());
+    auto queries = std::make_shared<std::vector<T>>();
+    for (size_t i = 0; i < LOOKUP_SIZE; ++i) {
+        queries->push_back(MakeValue<T>(i * 7 % (LOOKUP_SIZE * 2)));
+    }
+    return [set, queries] {
+        size_t found = 0;
+        for (const T& query : *queries) {
+            found += Contains(*set, query);
+        }
+        DoNotOptimize(found);
+        return LOOKUP_SIZE;
+    };
+}
+
+// Цикл обработчика запросов: на каждый запрос вектор создаётся, растёт до REQUEST_SIZE
+// элементов и разрушается
+template <typename Container, typename T>
+std::function<size_t()> Requests() {
+    return [] {
+        for (size_t request = 0; request < REQUESTS; ++request) {
+            Container c;
+            for (size_t i = 0; i < REQUEST_SIZE; ++i) {
+                PushBack(c, MakeValue<T>(i));
+            }
+            DoNotOptimize(c);
+        }
+        return REQUESTS * REQUEST_SIZE;
+    };
+}
+
+// То же с буферами из кеша потока (RecyclingAllocator) и подсказкой вместимости места вызова
+template <typename T>
+std::function<size_t()> RecycledRequests() {
+    return [] {
+        for (size_t request = 0; request < REQUESTS; ++request) {
+            RecyclingVector<T> c;
+            CapacityHintScope scope(VECTOR_CAPACITY_HINT(), c);
+            for (size_t i = 0; i < REQUEST_SIZE; ++i) {
+                c.PushBack(MakeValue<T>(i));
+            }
+            DoNotOptimize(c);
+        }
+        return REQUESTS * REQUEST_SIZE;
+    };
+}
+
+void PrintHeader() {
+    std::printf("%-14s %-14s %10s %10s %9s %9s %10s %10s %7s\n", "scenario", "type", "ns/op", "std ns/op",
+                "allocs/op", "std", "bytes/op", "std", "ratio");
+}
+
+void PrintRow(const char* scenario, const char* type, const Measurement& mine, const Measurement& reference) {
+    std::printf("%-14s %-14s %10.2f %10.2f %9.4f %9.4f %10.2f %10.2f %7.2f\n", scenario, type, mine.ns_per_op,
+                reference.ns_per_op, mine.allocations_per_op, reference.allocations_per_op, mine.bytes_per_op,
+                reference.bytes_per_op, mine.ns_per_op / reference.ns_per_op);
+}
+
+bool Matches(const BenchmarkConfig& config, std::string_view scenario, std::string_view type) {
+    return config.filter.empty() || scenario.find(config.filter) != std::string_view::npos
+        || type.find(config.filter) != std::string_view::npos;
+}
+
+template <typename T>
+void RunType(const BenchmarkConfig& config, const char* type) {
+    const auto run = [&](const char* scenario, const Scenario& mine, const Scenario& reference) {
+        if (Matches(config, scenario, type)) {
+            const Measurement my_result = Measure(config, mine);
+            const Measurement std_result = Measure(config, reference);
+            PrintRow(scenario, type, my_result, std_result);
+        }
+    };
+
+    run("push_back", PushBackGrowth<Vector<T>, T>(), PushBackGrowth<std::vector<T>, T>());
+    run("emplace_back", EmplaceBackGrowth<Vector<T>, T>(), EmplaceBackGrowth<std::vector<T>, T>());
+    run("reserve_fill", ReserveFill<Vector<T>, T>(), ReserveFill<std::vector<T>, T>());
+    run("insert_middle", InsertMiddle<Vector<T>, T>(), InsertMiddle<std::vector<T>, T>());
+    run("erase_middle", EraseMiddle<Vector<T>, T>(), EraseMiddle<std::vector<T>, T>());
+    run("copy_same", CopyAssign<Vector<T>, T>(GROWTH_SIZE), CopyAssign<std::vector<T>, T>(GROWTH_SIZE));
+    run("copy_shrink", CopyAssign<Vector<T>, T>(GROWTH_SIZE * 2), CopyAssign<std::vector<T>, T>(GROWTH_SIZE * 2));
+    run("copy_grow", CopyAssignGrow<Vector<T>, T>(), CopyAssignGrow<std::vector<T>, T>());
+    run("iterate", Iterate<Vector<T>, T>(), Iterate<std::vector<T>, T>());
+    run("sort", Sort<Vector<T>, T>(), Sort<std::vector<T>, T>());
+    run("lookup", Lookup<FlatSet<T>, T>(), Lookup<std::set<T>, T>());
+    run("requests", Requests<Vector<T>, T>(), Requests<std::vector<T>, T>());
+    run("recycled", RecycledRequests<T>(), Requests<std::vector<T>, T>());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        constexpr std::string_view MIN_TIME = "--min-time=";
+        if (arg.substr(0, MIN_TIME.size()) == MIN_TIME) {
+            config.min_time_seconds = std::strtod(arg.data() + MIN_TIME.size(), nullptr);
+        } else {
+            config.filter = arg;
+        }
+    }
+
+    PrintHeader();
+    RunType<int>(config, "int");
+    RunType<Pod64>(config, "pod64");
+    RunType<std::string>(config, "string");
+    RunType<ThrowingMove>(config, "throwing_move");
+
+    if constexpr (VectorStats::Enabled()) {
+        // Сборка с VECTOR_ENABLE_STATS (пресет release-instrumented): итоговые счётчики Vector
+        const VectorStatsSnapshot stats = VectorStats::Snapshot();
+        std::printf("\nallocations %llu, reallocations %llu, moved %llu, copied %llu, relocated bitwise %llu, "
+                    "peak live bytes %llu, wasted capacity bytes %llu, recycle hits %llu, recycle misses %llu\n",
+                    static_cast<unsigned long long>(stats.allocations),
+                    static_cast<unsigned long long>(stats.reallocations),
+                    static_cast<unsigned long long>(stats.elements_moved),
+                    static_cast<unsigned long long>(stats.elements_copied),
+                    static_cast<unsigned long long>(stats.elements_relocated_bitwise),
+                    static_cast<unsigned long long>(stats.peak_live_bytes),
+                    static_cast<unsigned long long>(stats.wasted_capacity_bytes),
+                    static_cast<unsigned long long>(stats.recycle_hits),
+                    static_cast<unsigned long long>(stats.recycle_misses));
+    }
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+
+// Вектор только для добавления, в который одновременно пишут несколько потоков.
+// Элементы хранятся в сегментах RawMemory: сегмент k вмещает FIRST_SEGMENT_SIZE << k элементов,
+// поэтому рост не перемещает уже добавленные элементы, ссылки на них остаются валидными,
+// а общая вместимость удваивается с каждым сегментом.
+// Добавление занимает слоты атомарным fetch_add без блокировок; сегменты создаются тем потоком,
+// который первым до них дошёл (проигравшие CAS освобождают свою копию). У каждого слота есть
+// флаг готовности: производитель отмечает свои слоты и продвигает Size() по непрерывному
+// префиксу готовых слотов. Поэтому Size() всегда задаёт полностью сконструированный префикс,
+// его можно читать параллельно с добавлением, а производитель никого не ждёт: если раньше
+// занятый слот ещё не готов, префикс продвинет тот, кто его допишет.
+// Clear и разрушение вектора не потокобезопасны относительно добавления.
+// Элемент конструируется до занятия слота, поэтому исключение конструктора ничего не нарушает.
+// Нехватка памяти под сегмент после занятия слота завершает программу (std::terminate):
+// занятый слот невозможно вернуть, не остановив публикацию для всех потоков. Чтобы этого
+// избежать, заранее резервируйте вместимость методом Reserve
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegmentSize = 64>
+class ConcurrentVector {
+    static_assert(FirstSegmentSize > 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0,
+                  "FirstSegmentSize must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "ConcurrentVector requires a noexcept move constructor");
+
+public:
+    using allocator_type = typename RawMemory<T, Alloc>::allocator_type;
+
+    static constexpr size_t FIRST_SEGMENT_SIZE = FirstSegmentSize;
+
+    // Слоты, занятые GrowBy. Элементы уже сконструированы по умолчанию и доступны только
+    // владельцу пакета; читатели увидят их после Commit (или разрушения пакета)
+    class Batch {
+    public:
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        Batch(Batch&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr))
+            , first_(other.first_)
+            , count_(other.count_) {
+        }
+
+        ~Batch() {
+            Commit();
+        }
+
+        size_t FirstIndex() const noexcept {
+            return first_;
+        }
+
+        size_t Size() const noexcept {
+            return count_;
+        }
+
+        // Вызывает fn(Span<T>) для каждого непрерывного участка пакета в порядке индексов.
+        // Пакет может пересекать границу сегментов, поэтому участков бывает несколько
+        template <typename Fn>
+        void ForEachSpan(Fn&& fn) const {
+            assert(owner_ != nullptr && "Batch is already committed");
+            owner_->ForEachSpan(first_, count_, fn);
+        }
+
+        T& operator[](size_t index) const noexcept {
+            assert(owner_ != nullptr && index < count_);
+            return owner_->Slot(first_ + index);
+        }
+
+        // Публикует элементы пакета. Повторный вызов ничего не делает
+        void Commit() noexcept {
+            if (owner_ != nullptr) {
+                std::exchange(owner_, nullptr)->MarkReady(first_, count_);
+            }
+        }
+
+    private:
+        friend class ConcurrentVector;
+
+        Batch(ConcurrentVector* owner, size_t first, size_t count) noexcept
+            : owner_(owner)
+            , first_(first)
+            , count_(count) {
+        }
+
+        ConcurrentVector* owner_;
+        size_t first_;
+        size_t count_;
+    };
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+    }
+
+    // Добавляет элемент и возвращает его индекс. Потокобезопасно
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        new (&EnsureSlot(index)) T(std::move(value));
+        MarkReady(index, 1);
+        return index;
+    }
+
+    size_t PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    size_t PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Занимает count подряд идущих слотов одним fetch_add и конструирует их по умолчанию.
+    // Производитель заполняет их через Batch::ForEachSpan и публикует через Commit. Потокобезопасно
+    Batch GrowBy(size_t count) {
+        static_assert(std::is_nothrow_default_constructible_v<T>,
+                      "GrowBy requires a noexcept default constructor");
+        const size_t first = claimed_.fetch_add(count, std::memory_order_relaxed);
+        ForEachSpan(first, count, [](Span<T> span) noexcept {
+            std::uninitialized_value_construct(span.begin(), span.end());
+        });
+        return Batch(this, first, count);
+    }
+
+    // Число опубликованных элементов — длина префикса готовых слотов. Элементы с индексами
+    // меньше Size() можно читать из любого потока
+    size_t Size() const noexcept {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    // Суммарная вместимость созданных сегментов
+    size_t Capacity() const noexcept {
+        size_t capacity = 0;
+        for (size_t k = 0; k < MAX_SEGMENTS; ++k) {
+            if (segments_[k].load(std::memory_order_acquire) != nullptr) {
+                capacity += SegmentSize(k);
+            }
+        }
+        return capacity;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Slot(index);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& At(size_t index) {
+        if (index >= Size()) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "ConcurrentVector::At: index out of range");
+        }
+        return Slot(index);
+    }
+
+    const T& At(size_t index) const {
+        return const_cast<ConcurrentVector&>(*this).At(index);
+    }
+
+    // Вызывает fn(Span<T>) для каждого участка опубликованного префикса в порядке индексов
+    template <typename Fn>
+    void ForEachSpan(Fn&& fn) {
+        ForEachSpan(0, Size(), fn);
+    }
+
+    // Создаёт сегменты, вмещающие не меньше capacity элементов. Исключение нехватки памяти
+    // распространяется. Можно вызывать параллельно с добавлением
+    void Reserve(size_t capacity) {
+        for (size_t k = 0; k < MAX_SEGMENTS && SegmentStart(k) < capacity; ++k) {
+            CreateSegment(k);
+        }
+    }
+
+    // Разрушает элементы и освобождает сегменты. Не потокобезопасно
+    void Clear() noexcept {
+        assert(claimed_.load() == published_.load() && "Clear during unfinished appends");
+        ForEachSpan(0, Size(), [](Span<T> span) noexcept {
+            std::destroy(span.begin(), span.end());
+        });
+        for (size_t k = 0; k < MAX_SEGMENTS; ++k) {
+            segments_[k].store(nullptr, std::memory_order_relaxed);
+            RawMemory<T, Alloc>(alloc_).Swap(storage_[k]);
+        }
+        claimed_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t FIRST_SEGMENT_SHIFT = vector_detail::HighestBit(FirstSegmentSize);
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SEGMENT_SHIFT;
+
+    using ReadyFlag = std::atomic<unsigned char>;
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    // Индекс первого элемента сегмента
+    static constexpr size_t SegmentStart(size_t segment) noexcept {
+        return SegmentSize(segment) - FirstSegmentSize;
+    }
+
+    // Номер сегмента, содержащего элемент index: старший бит числа index + FirstSegmentSize
+    static size_t SegmentOf(size_t index) noexcept {
+        return vector_detail::HighestBit(index + FirstSegmentSize) - FIRST_SEGMENT_SHIFT;
+    }
+
+    T& Slot(size_t index) const noexcept {
+        const size_t segment = SegmentOf(index);
+        return segments_[segment].load(std::memory_order_acquire)[index - SegmentStart(segment)];
+    }
+
+    // Адрес слота index; создаёт сегмент, если его ещё нет
+    T& EnsureSlot(size_t index) noexcept {
+        const size_t segment = SegmentOf(index);
+        T* data = segments_[segment].load(std::memory_order_acquire);
+        if (data == nullptr) {
+            // noexcept: исключение здесь вызывает std::terminate (см. комментарий к классу)
+            data = CreateSegment(segment);
+        }
+        return data[index - SegmentStart(segment)];
+    }
+
+    // Число элементов T, место которых занимают флаги готовности сегмента
+    static constexpr size_t FlagSlots(size_t segment) noexcept {
+        return (SegmentSize(segment) * sizeof(ReadyFlag) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    // Флаги готовности лежат в том же блоке сразу за элементами сегмента, поэтому публикуются
+    // вместе с ним одним CAS
+    static ReadyFlag* Flags(T* data, size_t segment) noexcept {
+        return reinterpret_cast<ReadyFlag*>(data + SegmentSize(segment));
+    }
+
+    // Истина, если слот index занят и его элемент сконструирован
+    bool IsReady(size_t index) const noexcept {
+        const size_t segment = SegmentOf(index);
+        T* data = segments_[segment].load(std::memory_order_acquire);
+        return data != nullptr && Flags(data, segment)[index - SegmentStart(segment)].load() != 0;
+    }
+
+    // Создаёт сегмент, если его ещё нет, и возвращает его адрес
+    T* CreateSegment(size_t segment) {
+        T* data = segments_[segment].load(std::memory_order_acquire);
+        if (data != nullptr) {
+            return data;
+        }
+        RawMemory<T, Alloc> memory(SegmentSize(segment) + FlagSlots(segment), alloc_);
+        std::uninitialized_value_construct_n(Flags(memory.GetAddress(), segment), SegmentSize(segment));
+        T* expected = nullptr;
+        if (segments_[segment].compare_exchange_strong(expected, memory.GetAddress(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            // Только победитель пишет в storage_[segment]; читатели обращаются к segments_
+            storage_[segment].Swap(memory);
+            return storage_[segment].GetAddress();
+        }
+        return expected;
+    }
+
+    // Вызывает fn для участков [first, first + count), создавая недостающие сегменты
+    template <typename Fn>
+    void ForEachSpan(size_t first, size_t count, Fn&& fn) {
+        while (count > 0) {
+            const size_t segment = SegmentOf(first);
+            const size_t length = std::min(count, SegmentStart(segment + 1) - first);
+            fn(Span<T>(&EnsureSlot(first), length));
+            first += length;
+            count -= length;
+        }
+    }
+
+    // Отмечает слоты [first, first + count) готовыми и продвигает опубликованный префикс.
+    // Не ждёт незаконченных слотов перед first: их допишет и опубликует другой производитель
+    void MarkReady(size_t first, size_t count) noexcept {
+        for (size_t index = first, last = first + count; index < last;) {
+            const size_t segment = SegmentOf(index);
+            ReadyFlag* flags = Flags(segments_[segment].load(std::memory_order_acquire), segment);
+            for (const size_t end = std::min(last, SegmentStart(segment + 1)); index < end; ++index) {
+                flags[index - SegmentStart(segment)].store(1);
+            }
+        }
+        AdvancePublished();
+    }
+
+    // Сдвигает published_ через готовые слоты. Флаги и published_ используют seq_cst: либо этот
+    // поток увидит флаг, который другой отметил, либо другой увидит сдвинутый префикс и
+    // продолжит сам — иначе готовый слот мог бы остаться неопубликованным
+    void AdvancePublished() noexcept {
+        size_t published = published_.load();
+        for (;;) {
+            size_t end = published;
+            while (IsReady(end)) {
+                ++end;
+            }
+            if (end == published) {
+                return;
+            }
+            if (published_.compare_exchange_weak(published, end)) {
+                published = end;
+            }
+        }
+    }
+
+    [[no_unique_address]] allocator_type alloc_;
+    std::atomic<T*> segments_[MAX_SEGMENTS] = {};
+    RawMemory<T, Alloc> storage_[MAX_SEGMENTS];
+    // Счётчики на отдельных кеш-линиях, чтобы занятие слотов не мешало читателям Size()
+    alignas(64) std::atomic<size_t> claimed_{0};
+    alignas(64) std::atomic<size_t> published_{0};
+};
@@ -0,0 +1,141 @@
+#include "vector.h"
+
+#include <cassert>
+#include <iostream>
+
+// Проверки Vector во время компиляции (C++20). Каждая функция возвращает истину при успехе
+// и вызывается дважды: в static_assert и во время выполнения, где работают memcpy/memmove-ветви
+
+#if !VECTOR_HAS_CONSTEXPR
+#error "constexpr_tests.cpp requires C++20 with constexpr std::allocator"
+#endif
+
+namespace {
+
+// Элемент с нетривиальными копированием и деструктором: во время компиляции проверяет
+// парность конструирования и разрушения через внешний счётчик
+struct Tracked {
+    constexpr Tracked(int value, int* live)
+        : value(value)
+        , live(live) {
+        ++*live;
+    }
+
+    constexpr Tracked(const Tracked& other)
+        : value(other.value)
+        , live(other.live) {
+        ++*live;
+    }
+
+    constexpr Tracked& operator=(const Tracked& other) {
+        value = other.value;
+        return *this;
+    }
+
+    constexpr ~Tracked() {
+        --*live;
+    }
+
+    int value;
+    int* live;
+};
+
+// Таблица квадратов, построенная вектором; копируется в массив, потому что выделенная
+// во время компиляции память не может пережить вычисление
+template <size_t N>
+struct SquareTable {
+    int values[N] = {};
+};
+
+template <size_t N>
+constexpr SquareTable<N> MakeSquares() {
+    Vector<int> squares;
+    for (size_t i = 0; i < N; ++i) {
+        squares.PushBack(static_cast<int>(i * i));
+    }
+    SquareTable<N> table;
+    for (size_t i = 0; i < N; ++i) {
+        table.values[i] = squares[i];
+    }
+    return table;
+}
+
+constexpr SquareTable<64> SQUARES = MakeSquares<64>();
+static_assert(SQUARES.values[0] == 0 && SQUARES.values[9] == 81 && SQUARES.values[63] == 3969);
+
+constexpr bool TestGrowth() {
+    Vector<int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.EmplaceBack(i);
+    }
+    if (v.Size() != 100 || v.Capacity() != 128 || v.front() != 0 || v.back() != 99) {
+        return false;
+    }
+    v.Reserve(300);
+    v.ShrinkToFit();
+    v.Resize(10);
+    v.PopBack();
+    return v.Size() == 9 && v.Capacity() == 100 && v[8] == 8;
+}
+
+constexpr bool TestInsertErase() {
+    Vector<int> v = {1, 2, 3, 4, 5};
+    v.Insert(v.begin() + 1, 10);
+    v.Insert(v.begin() + 2, size_t{2}, 20);
+    const int extra[] = {7, 8, 9};
+    v.Insert(v.begin(), extra, extra + 3);
+    v.Erase(v.begin() + 3, v.begin() + 5);
+    v.UnorderedErase(v.begin());
+    const Vector<int> expected = {5, 8, 9, 20, 20, 2, 3, 4};
+    return v == expected && !(v < expected) && v.At(3) == 20;
+}
+
+constexpr bool TestCopyAndMove() {
+    Vector<int> a(5, 7);
+    Vector<int> b = a;
+    b.Append({1, 2, 3});
+    a = b;
+    Vector<int> c = std::move(b);
+    Vector<int> d;
+    d = std::move(c);
+    d.Swap(a);
+    a.Assign(size_t{3}, 4);
+    return b.Empty() && c.Empty() && d.Size() == 8 && d[7] == 3 && a == Vector<int>{4, 4, 4};
+}
+
+constexpr bool TestNonTrivialElements() {
+    int live = 0;
+    {
+        Vector<Tracked> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i, &live);
+        }
+        v.Emplace(v.begin() + 3, 100, &live);
+        v.Erase(v.begin());
+        Vector<Tracked> copy = v;
+        copy.Erase(copy.begin() + 4, copy.end());
+        v.Clear();
+        if (live != 4 || copy[2].value != 100 || copy[3].value != 3) {
+            return false;
+        }
+    }
+    return live == 0;
+}
+
+static_assert(TestGrowth());
+static_assert(TestInsertErase());
+static_assert(TestCopyAndMove());
+static_assert(TestNonTrivialElements());
+
+}  // namespace
+
+int main() {
+    assert(SQUARES.values[10] == 100);
+    assert(MakeSquares<64>().values[63] == SQUARES.values[63]);
+    assert(TestGrowth());
+    assert(TestInsertErase());
+    assert(TestCopyAndMove());
+    assert(TestNonTrivialElements());
+    std::cout << "All constexpr tests passed!" << std::endl;
+    return 0;
+}
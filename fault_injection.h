@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Инструменты проверки гарантий безопасности исключений контейнеров: тип элемента и аллокатор,
+// которые выбрасывают исключение на N-м событии, счётчики событий и перебор точек отказа.
+// Состояние глобальное и не синхронизировано: проверки выполняются в одном потоке
+
+// Виды событий, на которых может произойти отказ. Значения — биты маски FaultInjector::Arm
+enum FaultPoint : unsigned {
+    FAULT_CONSTRUCT = 1,    // конструктор по умолчанию и из значения
+    FAULT_COPY = 2,         // копирующий конструктор
+    FAULT_MOVE = 4,         // перемещающий конструктор
+    FAULT_ASSIGN = 8,       // копирующее и перемещающее присваивание
+    FAULT_ALLOCATE = 16,    // выделение памяти аллокатором
+    FAULT_ALL = 31,
+};
+
+// Исключение, которое выбрасывает FaultyValue. Аллокатор при отказе выбрасывает std::bad_alloc
+struct InjectedFault {
+    FaultPoint point;
+};
+
+// Счётчик событий и отложенный отказ
+class FaultInjector {
+public:
+    // Отказ произойдёт на countdown-м (с единицы) событии из маски points
+    static void Arm(size_t countdown, unsigned points = FAULT_ALL) noexcept {
+        countdown_ = countdown;
+        points_ = points;
+    }
+
+    static void Disarm() noexcept {
+        countdown_ = 0;
+    }
+
+    // Регистрирует событие; возвращает истину, если на нём назначен отказ
+    static bool Hit(FaultPoint point) noexcept {
+        ++counts_[Index(point)];
+        if (countdown_ == 0 || (points_ & point) == 0) {
+            return false;
+        }
+        return --countdown_ == 0;
+    }
+
+    static size_t Count(FaultPoint point) noexcept {
+        return counts_[Index(point)];
+    }
+
+    static void ResetCounts() noexcept {
+        for (size_t& count : counts_) {
+            count = 0;
+        }
+    }
+
+private:
+    static size_t Index(FaultPoint point) noexcept {
+        size_t index = 0;
+        for (unsigned bits = point; bits > 1; bits >>= 1) {
+            ++index;
+        }
+        return index;
+    }
+
+    static inline size_t countdown_ = 0;
+    static inline unsigned points_ = FAULT_ALL;
+    static inline size_t counts_[5] = {};
+};
+
+// Элемент контейнера, каждая операция которого — точка отказа. Следит за числом живых объектов
+// и по «печати» в самом объекте обнаруживает использование неинициализированной или уже
+// разрушенной памяти. NoexceptMove определяет, могут ли выбросить перемещающие конструктор
+// и присваивание: при true они только подсчитываются
+template <bool NoexceptMove>
+class BasicFaultyValue {
+public:
+    BasicFaultyValue() {
+        Construct(FAULT_CONSTRUCT, 0);
+    }
+
+    BasicFaultyValue(int value) {
+        Construct(FAULT_CONSTRUCT, value);
+    }
+
+    BasicFaultyValue(const BasicFaultyValue& other) {
+        Construct(FAULT_COPY, other.Value());
+    }
+
+    BasicFaultyValue(BasicFaultyValue&& other) noexcept(NoexceptMove) {
+        if constexpr (NoexceptMove) {
+            FaultInjector::Hit(FAULT_MOVE);
+            Init(other.Value());
+        } else {
+            Construct(FAULT_MOVE, other.Value());
+        }
+    }
+
+    BasicFaultyValue& operator=(const BasicFaultyValue& other) {
+        Assign(other.Value());
+        return *this;
+    }
+
+    BasicFaultyValue& operator=(BasicFaultyValue&& other) noexcept(NoexceptMove) {
+        if constexpr (NoexceptMove) {
+            FaultInjector::Hit(FAULT_ASSIGN);
+            value_ = other.Value();
+        } else {
+            Assign(other.Value());
+        }
+        return *this;
+    }
+
+    ~BasicFaultyValue() {
+        assert(Valid() && "FaultyValue: destroying an invalid object");
+        cookie_ = 0;
+        --live_;
+    }
+
+    int Value() const noexcept {
+        assert(Valid() && "FaultyValue: using an invalid object");
+        return value_;
+    }
+
+    bool Valid() const noexcept {
+        return cookie_ == COOKIE;
+    }
+
+    bool operator==(const BasicFaultyValue& other) const noexcept {
+        return Value() == other.Value();
+    }
+
+    bool operator!=(const BasicFaultyValue& other) const noexcept {
+        return !(*this == other);
+    }
+
+    // Число сконструированных и ещё не разрушенных объектов
+    static long Live() noexcept {
+        return live_;
+    }
+
+private:
+    static constexpr uint32_t COOKIE = 0xfa17c0de;
+
+    void Construct(FaultPoint point, int value) {
+        if (FaultInjector::Hit(point)) {
+            throw InjectedFault{point};
+        }
+        Init(value);
+    }
+
+    void Init(int value) noexcept {
+        value_ = value;
+        cookie_ = COOKIE;
+        ++live_;
+    }
+
+    void Assign(int value) {
+        assert(Valid() && "FaultyValue: assigning to an invalid object");
+        if (FaultInjector::Hit(FAULT_ASSIGN)) {
+            throw InjectedFault{FAULT_ASSIGN};
+        }
+        value_ = value;
+    }
+
+    int value_ = 0;
+    uint32_t cookie_ = 0;
+
+    static inline long live_ = 0;
+};
+
+using FaultyValue = BasicFaultyValue<false>;
+using NothrowMoveFaultyValue = BasicFaultyValue<true>;
+
+// Общие для всех FaultyAllocator<T> счётчики
+struct AllocationCounters {
+    static inline size_t allocations = 0;
+    static inline size_t live_bytes = 0;
+};
+
+// Аллокатор, считающий выделения и живые байты; выделение памяти — точка отказа FAULT_ALLOCATE
+template <typename T>
+struct FaultyAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    FaultyAllocator() = default;
+
+    template <typename U>
+    FaultyAllocator(const FaultyAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (FaultInjector::Hit(FAULT_ALLOCATE)) {
+            throw std::bad_alloc();
+        }
+        T* result = std::allocator<T>{}.allocate(n);
+        AllocationCounters::allocations += 1;
+        AllocationCounters::live_bytes += n * sizeof(T);
+        return result;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        assert(AllocationCounters::live_bytes >= n * sizeof(T) && "FaultyAllocator: freeing foreign memory");
+        AllocationCounters::live_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const FaultyAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const FaultyAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+// Гарантия, которую операция обязана дать при исключении
+enum class ExceptionGuarantee {
+    BASIC,   // контейнер остаётся корректным, утечек нет
+    STRONG,  // содержимое контейнера не меняется
+};
+
+// Перебирает точки отказа операции: для N = 1, 2, ... создаёт контейнер через make(), назначает
+// отказ на N-е событие из маски points и выполняет operation(container). При исключении проверяет,
+// что все элементы корректны, а для строгой гарантии — что содержимое совпадает с исходным.
+// После каждой попытки контейнер разрушается и проверяется отсутствие утечек объектов и памяти.
+// Перебор заканчивается на первой попытке без отказа, после которой вызывается check(container).
+// Возвращает число попыток, завершившихся отказом
+template <typename Make, typename Operation, typename Check>
+size_t SweepFaults(ExceptionGuarantee guarantee, unsigned points, Make&& make, Operation&& operation,
+                   Check&& check) {
+    using Container = std::decay_t<decltype(make())>;
+    using Value = std::remove_reference_t<decltype(*std::declval<Container&>().begin())>;
+    const long live_before = Value::Live();
+    const size_t bytes_before = AllocationCounters::live_bytes;
+
+    for (size_t countdown = 1;; ++countdown) {
+        bool failed = false;
+        {
+            Container container = make();
+            std::vector<int> before;
+            for (const Value& value : container) {
+                before.push_back(value.Value());
+            }
+
+            FaultInjector::Arm(countdown, points);
+            try {
+                operation(container);
+            } catch (const InjectedFault&) {
+                failed = true;
+            } catch (const std::bad_alloc&) {
+                failed = true;
+            }
+            FaultInjector::Disarm();
+
+            if (failed) {
+                for (const Value& value : container) {
+                    assert(value.Valid() && "SweepFaults: invalid element after an exception");
+                }
+                assert(container.Size() <= container.Capacity());
+                if (guarantee == ExceptionGuarantee::STRONG) {
+                    assert(container.Size() == before.size() && "SweepFaults: strong guarantee violated");
+                    for (size_t i = 0; i < before.size(); ++i) {
+                        assert(container[i].Value() == before[i] && "SweepFaults: strong guarantee violated");
+                    }
+                }
+            } else {
+                check(container);
+            }
+        }
+        assert(Value::Live() == live_before && "SweepFaults: leaked or doubly destroyed elements");
+        assert(AllocationCounters::live_bytes == bytes_before && "SweepFaults: leaked memory");
+        if (!failed) {
+            return countdown - 1;
+        }
+    }
+}
+
+// Число выделений памяти аллокатором FaultyAllocator во время operation()
+template <typename Operation>
+size_t CountAllocations(Operation&& operation) {
+    const size_t before = AllocationCounters::allocations;
+    operation();
+    return AllocationCounters::allocations - before;
+}
@@ -0,0 +1,312 @@
+// Перебор точек отказа для операций Vector: каждая операция выполняется столько раз, сколько в ней
+// событий, и на каждом следующем событии выбрасывается исключение (см. fault_injection.h).
+// Сборка с санитайзерами: цель fault_tests в CMakeLists.txt или
+// g++ -std=c++17 -g -fsanitize=address,undefined fault_tests.cpp -o fault_tests
+
+#include "vector.h"
+#include "fault_injection.h"
+
+#include <cassert>
+#include <iostream>
+
+namespace {
+
+template <typename Value>
+using FaultyVector = Vector<Value, FaultyAllocator<Value>>;
+
+// Вектор из значений 0, 1, ..., size - 1 с вместимостью capacity
+template <typename Value>
+FaultyVector<Value> MakeVector(size_t size, size_t capacity) {
+    FaultyVector<Value> v;
+    v.Reserve(capacity);
+    for (size_t i = 0; i < size; ++i) {
+        v.EmplaceBack(static_cast<int>(i));
+    }
+    return v;
+}
+
+// Проверка, что значения вектора совпадают с ожидаемыми
+template <typename Value>
+void ExpectValues(const FaultyVector<Value>& v, std::initializer_list<int> expected) {
+    assert(v.Size() == expected.size());
+    size_t i = 0;
+    for (int value : expected) {
+        assert(v[i++].Value() == value);
+    }
+}
+
+// Значения 0, 1, ..., count - 1, начиная с позиции first
+template <typename Value>
+void ExpectIota(const FaultyVector<Value>& v, size_t first, size_t count, int start = 0) {
+    for (size_t i = 0; i < count; ++i) {
+        assert(v[first + i].Value() == start + static_cast<int>(i));
+    }
+}
+
+// Ожидаемые точки отказа операции. Перебор без единого отказа у операции, которая должна их
+// содержать, значит, что она до них не доходит (например, перестала выделять память или копировать)
+enum class Faults {
+    SOME,                  // операция выделяет память, конструирует, копирует или присваивает
+    NONE,                  // уменьшение размера, PopBack, Clear, перемещение буфера
+    NONE_IF_NOTHROW_MOVE,  // удаление со сдвигом перемещающим присваиванием
+};
+
+template <typename Value>
+void Sweep(ExceptionGuarantee guarantee, size_t size, size_t capacity,
+           void (*operation)(FaultyVector<Value>&), void (*check)(FaultyVector<Value>&),
+           Faults expected = Faults::SOME) {
+    const size_t faults = SweepFaults(
+        guarantee, FAULT_ALL,
+        [size, capacity] {
+            return MakeVector<Value>(size, capacity);
+        },
+        operation, check);
+    const bool fault_free = expected == Faults::NONE ||
+        (expected == Faults::NONE_IF_NOTHROW_MOVE && std::is_nothrow_move_assignable_v<Value>);
+    assert((faults == 0) == fault_free && "Sweep: unexpected number of fault points");
+}
+
+constexpr ExceptionGuarantee STRONG = ExceptionGuarantee::STRONG;
+constexpr ExceptionGuarantee BASIC = ExceptionGuarantee::BASIC;
+
+template <typename Value>
+void SweepCapacityOperations() {
+    using V = FaultyVector<Value>;
+    Sweep<Value>(STRONG, 5, 5, [](V& v) { v.Reserve(20); },
+                 [](V& v) { assert(v.Capacity() == 20); ExpectIota(v, 0, 5); });
+    Sweep<Value>(STRONG, 5, 16, [](V& v) { v.ShrinkToFit(); },
+                 [](V& v) { assert(v.Capacity() == 5); ExpectIota(v, 0, 5); });
+    Sweep<Value>(STRONG, 3, 3, [](V& v) { v.Resize(6); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 0, 0, 0}); });
+    Sweep<Value>(STRONG, 3, 8, [](V& v) { v.Resize(6); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 0, 0, 0}); });
+    Sweep<Value>(STRONG, 6, 6, [](V& v) { v.Resize(2); }, [](V& v) { ExpectValues(v, {0, 1}); }, Faults::NONE);
+    Sweep<Value>(STRONG, 3, 3, [](V& v) { v.ResizeDefaultInit(5); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 0, 0}); });
+}
+
+template <typename Value>
+void SweepInsertions() {
+    using V = FaultyVector<Value>;
+    // Вставка в конец: строгая гарантия и с реаллокацией, и без неё
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.EmplaceBack(100); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 100}); });
+    Sweep<Value>(STRONG, 4, 8, [](V& v) { v.EmplaceBack(100); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 100}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.EmplaceBack(v[1]); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 1}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.PushBack(v[2]); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 2}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.PushBack(Value(7)); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 7}); });
+    Sweep<Value>(STRONG, 4, 4,
+                 [](V& v) {
+                     auto guard = v.GrowBy(3);
+                     for (int i = 0; i < 3; ++i) {
+                         guard.Emplace(10 + i);
+                     }
+                     guard.Commit();
+                 },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 10, 11, 12}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.Append({8, 9}); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 3, 8, 9}); });
+
+    // Вставка в середину с реаллокацией строгая, без неё — базовая
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.Emplace(v.begin() + 1, 100); },
+                 [](V& v) { ExpectValues(v, {0, 100, 1, 2, 3}); });
+    Sweep<Value>(BASIC, 4, 8, [](V& v) { v.Emplace(v.begin() + 1, 100); },
+                 [](V& v) { ExpectValues(v, {0, 100, 1, 2, 3}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.Insert(v.begin() + 2, v[0]); },
+                 [](V& v) { ExpectValues(v, {0, 1, 0, 2, 3}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.Insert(v.begin() + 1, 3, Value(5)); },
+                 [](V& v) { ExpectValues(v, {0, 5, 5, 5, 1, 2, 3}); });
+    Sweep<Value>(BASIC, 4, 10, [](V& v) { v.Insert(v.begin() + 1, 3, Value(5)); },
+                 [](V& v) { ExpectValues(v, {0, 5, 5, 5, 1, 2, 3}); });
+    Sweep<Value>(STRONG, 4, 4, [](V& v) { v.Insert(v.begin() + 3, {6, 7}); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 6, 7, 3}); });
+    Sweep<Value>(BASIC, 4, 10, [](V& v) { v.Insert(v.begin() + 3, {6, 7}); },
+                 [](V& v) { ExpectValues(v, {0, 1, 2, 6, 7, 3}); });
+    Sweep<Value>(BASIC, 4, 10, [](V& v) { v.Insert(v.begin(), {6, 7, 8, 9, 10, 11}); },
+                 [](V& v) { ExpectValues(v, {6, 7, 8, 9, 10, 11, 0, 1, 2, 3}); });
+}
+
+template <typename Value>
+void SweepErasures() {
+    using V = FaultyVector<Value>;
+    constexpr Faults SHIFT = Faults::NONE_IF_NOTHROW_MOVE;
+    Sweep<Value>(BASIC, 5, 5, [](V& v) { v.Erase(v.begin() + 1); },
+                 [](V& v) { ExpectValues(v, {0, 2, 3, 4}); }, SHIFT);
+    Sweep<Value>(BASIC, 6, 6, [](V& v) { v.Erase(v.begin() + 1, v.begin() + 3); },
+                 [](V& v) { ExpectValues(v, {0, 3, 4, 5}); }, SHIFT);
+    Sweep<Value>(BASIC, 6, 6, [](V& v) { v.EraseIf([](const Value& value) { return value.Value() % 2 == 0; }); },
+                 [](V& v) { ExpectValues(v, {1, 3, 5}); }, SHIFT);
+    Sweep<Value>(BASIC, 5, 5, [](V& v) { v.UnorderedErase(v.begin() + 1); },
+                 [](V& v) { ExpectValues(v, {0, 4, 2, 3}); }, SHIFT);
+    Sweep<Value>(STRONG, 5, 5, [](V& v) { v.PopBack(); }, [](V& v) { ExpectValues(v, {0, 1, 2, 3}); },
+                 Faults::NONE);
+    Sweep<Value>(STRONG, 5, 5, [](V& v) { v.Clear(); }, [](V& v) { assert(v.Empty() && v.Capacity() == 5); },
+                 Faults::NONE);
+}
+
+template <typename Value>
+void SweepAssignments() {
+    using V = FaultyVector<Value>;
+    // Копирующее присваивание: при нехватке вместимости строгая гарантия, иначе базовая
+    Sweep<Value>(STRONG, 2, 2, [](V& v) { v = MakeVector<Value>(6, 6); },
+                 [](V& v) { ExpectIota(v, 0, 6); });
+    Sweep<Value>(STRONG, 2, 2,
+                 [](V& v) {
+                     const V source = MakeVector<Value>(6, 6);
+                     v = source;
+                 },
+                 [](V& v) { assert(v.Size() == 6); ExpectIota(v, 0, 6); });
+    Sweep<Value>(BASIC, 6, 6,
+                 [](V& v) {
+                     V source;
+                     source.Append({10, 11, 12});
+                     v = source;
+                 },
+                 [](V& v) { ExpectValues(v, {10, 11, 12}); });
+    Sweep<Value>(BASIC, 2, 8,
+                 [](V& v) {
+                     V source;
+                     source.Append({10, 11, 12, 13});
+                     v = source;
+                 },
+                 [](V& v) { ExpectValues(v, {10, 11, 12, 13}); });
+    Sweep<Value>(STRONG, 2, 2,
+                 [](V& v) {
+                     const V source = MakeVector<Value>(5, 5);
+                     v.ParallelCopyFrom(source, ParallelTag(1));
+                 },
+                 [](V& v) { ExpectIota(v, 0, 5); });
+    Sweep<Value>(BASIC, 5, 5,
+                 [](V& v) {
+                     const V source = MakeVector<Value>(2, 2);
+                     v.ParallelCopyFrom(source, ParallelTag(1));
+                 },
+                 [](V& v) { ExpectValues(v, {0, 1}); });
+    Sweep<Value>(BASIC, 3, 3, [](V& v) { v.Assign(5, Value(4)); },
+                 [](V& v) { ExpectValues(v, {4, 4, 4, 4, 4}); });
+    Sweep<Value>(BASIC, 5, 5, [](V& v) { v.Assign(2, Value(4)); }, [](V& v) { ExpectValues(v, {4, 4}); });
+    Sweep<Value>(BASIC, 2, 6, [](V& v) { v.Assign({7, 8, 9}); }, [](V& v) { ExpectValues(v, {7, 8, 9}); });
+    Sweep<Value>(BASIC, 2, 2, [](V& v) { v = {7, 8, 9}; }, [](V& v) { ExpectValues(v, {7, 8, 9}); });
+    Sweep<Value>(STRONG, 3, 3,
+                 [](V& v) {
+                     V other = MakeVector<Value>(1, 1);
+                     v.Swap(other);
+                     v.Swap(other);
+                 },
+                 [](V& v) { ExpectValues(v, {0, 1, 2}); });
+}
+
+template <typename Value>
+void SweepConstructors() {
+    using V = FaultyVector<Value>;
+    // Исходный вектор не должен меняться, а частично построенный — не оставлять утечек
+    Sweep<Value>(STRONG, 4, 4,
+                 [](V& v) {
+                     const V copy(v);
+                     ExpectIota(copy, 0, 4);
+                 },
+                 [](V& /*v*/) {});
+    Sweep<Value>(STRONG, 4, 4,
+                 [](V& v) {
+                     const V copy(v, ParallelTag(1));
+                     ExpectIota(copy, 0, 4);
+                 },
+                 [](V& /*v*/) {});
+    Sweep<Value>(STRONG, 0, 0, [](V& v) { v = V(5); }, [](V& v) { ExpectValues(v, {0, 0, 0, 0, 0}); });
+    Sweep<Value>(STRONG, 0, 0, [](V& v) { v = V(3, Value(2)); }, [](V& v) { ExpectValues(v, {2, 2, 2}); });
+    Sweep<Value>(STRONG, 0, 0, [](V& v) { v = V({1, 2, 3}); }, [](V& v) { ExpectValues(v, {1, 2, 3}); });
+    Sweep<Value>(STRONG, 0, 0, [](V& v) { v = V(4, ParallelTag(1)); },
+                 [](V& v) { ExpectValues(v, {0, 0, 0, 0}); });
+    Sweep<Value>(STRONG, 4, 4,
+                 [](V& v) {
+                     V moved(std::move(v));
+                     v = std::move(moved);
+                 },
+                 [](V& v) { ExpectIota(v, 0, 4); }, Faults::NONE);
+}
+
+// Перенос при реаллокации: перемещение, если оно не выбрасывает, иначе копирование
+template <typename Value>
+void CheckRelocationCounts() {
+    FaultyVector<Value> v = MakeVector<Value>(8, 8);
+    FaultInjector::ResetCounts();
+    v.EmplaceBack(8);
+    const bool nothrow_move = std::is_nothrow_move_constructible_v<Value>;
+    assert(FaultInjector::Count(FAULT_MOVE) == (nothrow_move ? 8 : 0));
+    assert(FaultInjector::Count(FAULT_COPY) == (nothrow_move ? 0 : 8));
+    assert(FaultInjector::Count(FAULT_CONSTRUCT) == 1 && FaultInjector::Count(FAULT_ALLOCATE) == 1);
+}
+
+// Число выделений памяти на операцию
+template <typename Value>
+void CheckAllocationCounts() {
+    using V = FaultyVector<Value>;
+    V v = MakeVector<Value>(4, 8);
+    const V same = MakeVector<Value>(4, 4);
+    const V small = MakeVector<Value>(2, 2);
+    const V large = MakeVector<Value>(8, 8);
+    const V larger = MakeVector<Value>(9, 9);
+    const V empty;
+
+    assert(CountAllocations([&] { v.EmplaceBack(4); }) == 0);
+    assert(CountAllocations([&] { v.PopBack(); }) == 0);
+    assert(CountAllocations([&] { v.GrowBy(4).Commit(); }) == 0);
+    assert(CountAllocations([&] { v.Insert(v.begin(), 2, Value(1)); }) == 0);
+    assert(CountAllocations([&] { v.Erase(v.begin(), v.begin() + 2); }) == 0);
+    assert(CountAllocations([&] { v.Reserve(8); }) == 0);
+    assert(CountAllocations([&] { v = same; }) == 0);
+    assert(CountAllocations([&] { v = small; }) == 0);
+    assert(CountAllocations([&] { v = large; }) == 0);
+    assert(CountAllocations([&] { v.Assign(3, Value(1)); }) == 0);
+    assert(CountAllocations([&] { v.Resize(8); }) == 0);
+    assert(CountAllocations([&] { v.Clear(); }) == 0);
+    assert(CountAllocations([&] { V moved(std::move(v)); v = std::move(moved); }) == 0);
+    assert(CountAllocations([&] { V copy(empty); }) == 0);
+
+    assert(CountAllocations([&] { v = larger; }) == 1);
+    assert(v.Capacity() == 16);
+    assert(CountAllocations([&] { v.Reserve(40); }) == 1);
+    assert(CountAllocations([&] { v.ShrinkToFit(); }) == 1);
+    assert(CountAllocations([&] { V copy(v); }) == 1);
+    assert(CountAllocations([&] { v.Insert(v.begin(), 20, Value(3)); }) == 1);
+
+    // Рост с нуля удвоением: 1, 2, 4, ..., 1024
+    V grown;
+    assert(CountAllocations([&] {
+               for (int i = 0; i < 1000; ++i) {
+                   grown.EmplaceBack(i);
+               }
+           }) == 11);
+    V batched;
+    assert(CountAllocations([&] {
+               auto guard = batched.GrowBy(1000);
+               for (int i = 0; i < 1000; ++i) {
+                   guard.Emplace(i);
+               }
+               guard.Commit();
+           }) == 1);
+}
+
+template <typename Value>
+void SweepAll() {
+    SweepCapacityOperations<Value>();
+    SweepInsertions<Value>();
+    SweepErasures<Value>();
+    SweepAssignments<Value>();
+    SweepConstructors<Value>();
+    CheckRelocationCounts<Value>();
+    CheckAllocationCounts<Value>();
+    assert(Value::Live() == 0 && AllocationCounters::live_bytes == 0);
+}
+
+}  // namespace
+
+int main() {
+    SweepAll<FaultyValue>();
+    SweepAll<NothrowMoveFaultyValue>();
+    std::cout << "All fault injection tests passed!" << std::endl;
+}
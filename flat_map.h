@@ -0,0 +1,467 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Упорядоченные ассоциативные контейнеры поверх Vector: ключи хранятся отсортированными
+// в непрерывном массиве, поиск — двоичный без ветвлений (см. vector_detail::LowerBoundIndex).
+// По сравнению с std::map поиск не ходит по указателям и читает соседние строки кэша, зато
+// вставка и удаление по одному элементу сдвигают хвост за O(N). Поэтому наборы ключей лучше
+// добавлять пакетно через InsertSorted: один проход слияния вместо N сдвигов.
+// Итераторы и указатели на элементы становятся недействительными после любого изменения
+
+namespace vector_detail {
+
+// Индекс первого элемента отсортированного массива, не меньшего key. Цикл не зависит от
+// результатов сравнений (их результат выбирает указатель, что компилируется в cmov), поэтому
+// нет ошибок предсказания переходов, а число итераций — ровно log2(size)
+template <typename K, typename Compare>
+size_t LowerBoundIndex(const K* data, size_t size, const K& key, const Compare& less) {
+    if (size == 0) {
+        return 0;
+    }
+    const K* base = data;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = less(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - data) + (less(*base, key) ? 1 : 0);
+}
+
+// Перемещение при MOVE, иначе копирование
+template <bool MOVE, typename T>
+std::conditional_t<MOVE, T&&, const T&> Take(T& value) noexcept {
+    return static_cast<std::conditional_t<MOVE, T&&, const T&>>(value);
+}
+
+}  // namespace vector_detail
+
+// Множество уникальных ключей в отсортированном Vector
+template <typename K, typename Compare = std::less<K>>
+class FlatSet {
+public:
+    using iterator = const K*;
+    using const_iterator = const K*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& less)
+        : less_(less) {
+    }
+
+    // Ключи могут идти в любом порядке, повторы отбрасываются
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    FlatSet(InputIt first, InputIt last, const Compare& less = Compare())
+        : keys_(first, last)
+        , less_(less) {
+        SortUnique();
+    }
+
+    FlatSet(std::initializer_list<K> init, const Compare& less = Compare())
+        : FlatSet(init.begin(), init.end(), less) {
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return keys_.Empty();
+    }
+
+    size_t Capacity() const noexcept {
+        return keys_.Capacity();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    void ShrinkToFit() {
+        keys_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    // Отсортированные ключи одним непрерывным диапазоном
+    Span<const K> Keys() const noexcept {
+        return Span<const K>(keys_.begin(), keys_.Size());
+    }
+
+    const_iterator LowerBound(const K& key) const {
+        return begin() + LowerBoundIndex(key);
+    }
+
+    const_iterator UpperBound(const K& key) const {
+        const_iterator it = LowerBound(key);
+        return it != end() && !less_(key, *it) ? it + 1 : it;
+    }
+
+    const_iterator Find(const K& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return IsKeyAt(index, key) ? begin() + index : end();
+    }
+
+    bool Contains(const K& key) const {
+        return IsKeyAt(LowerBoundIndex(key), key);
+    }
+
+    size_t Count(const K& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Вставка одного ключа со сдвигом хвоста. Возвращает позицию ключа и признак вставки
+    std::pair<const_iterator, bool> Insert(const K& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (IsKeyAt(index, key)) {
+            return {begin() + index, false};
+        }
+        keys_.Insert(keys_.begin() + index, key);
+        return {begin() + index, true};
+    }
+
+    std::pair<const_iterator, bool> Insert(K&& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (IsKeyAt(index, key)) {
+            return {begin() + index, false};
+        }
+        keys_.Insert(keys_.begin() + index, std::move(key));
+        return {begin() + index, true};
+    }
+
+    // Слияние с отсортированным по возрастанию диапазоном за один проход: O(Size() + N) вместо
+    // N вставок со сдвигом. Ключи, уже входящие в множество, и повторы внутри диапазона
+    // отбрасываются. Диапазон сначала копируется во временный буфер, а слияние переносит ключи
+    // в новый буфер точного размера, поэтому при исключении множество не меняется
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void InsertSorted(InputIt first, InputIt last) {
+        Vector<K> incoming(first, last);
+        assert(std::is_sorted(incoming.begin(), incoming.end(), less_) && "InsertSorted: range is not sorted");
+        MergeSorted(incoming);
+    }
+
+    size_t Erase(const K& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (!IsKeyAt(index, key)) {
+            return 0;
+        }
+        keys_.Erase(keys_.begin() + index);
+        return 1;
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        return keys_.Erase(pos);
+    }
+
+    bool operator==(const FlatSet& other) const {
+        return keys_ == other.keys_;
+    }
+
+    bool operator!=(const FlatSet& other) const {
+        return !(*this == other);
+    }
+
+private:
+    size_t LowerBoundIndex(const K& key) const {
+        return vector_detail::LowerBoundIndex(keys_.begin(), keys_.Size(), key, less_);
+    }
+
+    bool IsKeyAt(size_t index, const K& key) const {
+        return index < keys_.Size() && !less_(key, keys_[index]);
+    }
+
+    bool Equivalent(const K& lhs, const K& rhs) const {
+        return !less_(lhs, rhs) && !less_(rhs, lhs);
+    }
+
+    void SortUnique() {
+        std::stable_sort(keys_.begin(), keys_.end(), less_);
+        keys_.Erase(std::unique(keys_.begin(), keys_.end(),
+                                [this](const K& lhs, const K& rhs) { return Equivalent(lhs, rhs); }),
+                    keys_.end());
+    }
+
+    // Если перенос ключа не выбрасывает исключений, ключи переносятся, иначе копируются:
+    // слияние в зарезервированный буфер не выбрасывает, пока исходный буфер не тронут
+    void MergeSorted(Vector<K>& incoming) {
+        constexpr bool MOVE = std::is_nothrow_move_constructible_v<K>;
+        Vector<K> merged;
+        merged.Reserve(keys_.Size() + incoming.Size());
+        K* it = keys_.begin();
+        for (K& key : incoming) {
+            while (it != keys_.end() && less_(*it, key)) {
+                merged.PushBack(vector_detail::Take<MOVE>(*it++));
+            }
+            const bool present = (it != keys_.end() && !less_(key, *it))
+                || (!merged.Empty() && !less_(merged.back(), key));
+            if (!present) {
+                merged.PushBack(vector_detail::Take<MOVE>(key));
+            }
+        }
+        for (; it != keys_.end(); ++it) {
+            merged.PushBack(vector_detail::Take<MOVE>(*it));
+        }
+        keys_.Swap(merged);
+    }
+
+    Vector<K> keys_;
+    [[no_unique_address]] Compare less_;
+};
+
+// Словарь с отсортированными ключами. Ключи и значения хранятся в отдельных столбцах: поиск
+// проходит только по плотному массиву ключей, а Keys() можно сканировать векторизованными
+// алгоритмами. Значение с индексом i соответствует ключу с индексом i
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+public:
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& less)
+        : less_(less) {
+    }
+
+    // Пары могут идти в любом порядке; из пар с одинаковым ключом остаётся первая
+    FlatMap(std::initializer_list<std::pair<K, V>> init, const Compare& less = Compare())
+        : less_(less) {
+        Vector<std::pair<K, V>> pairs(init.begin(), init.end());
+        std::stable_sort(pairs.begin(), pairs.end(), [this](const auto& lhs, const auto& rhs) {
+            return less_(lhs.first, rhs.first);
+        });
+        InsertSorted(pairs.begin(), pairs.end());
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return keys_.Empty();
+    }
+
+    size_t Capacity() const noexcept {
+        return std::min(keys_.Capacity(), values_.Capacity());
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void ShrinkToFit() {
+        keys_.ShrinkToFit();
+        values_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    Span<const K> Keys() const noexcept {
+        return Span<const K>(keys_.begin(), keys_.Size());
+    }
+
+    Span<V> Values() noexcept {
+        return Span<V>(values_.begin(), values_.Size());
+    }
+
+    Span<const V> Values() const noexcept {
+        return Span<const V>(values_.begin(), values_.Size());
+    }
+
+    const K& KeyAt(size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    V& ValueAt(size_t index) noexcept {
+        return values_[index];
+    }
+
+    const V& ValueAt(size_t index) const noexcept {
+        return values_[index];
+    }
+
+    // Индекс первого ключа, не меньшего key
+    size_t LowerBound(const K& key) const {
+        return vector_detail::LowerBoundIndex(keys_.begin(), keys_.Size(), key, less_);
+    }
+
+    // Указатель на значение по ключу; nullptr, если ключа нет
+    V* Find(const K& key) {
+        const size_t index = LowerBound(key);
+        return IsKeyAt(index, key) ? &values_[index] : nullptr;
+    }
+
+    const V* Find(const K& key) const {
+        const size_t index = LowerBound(key);
+        return IsKeyAt(index, key) ? &values_[index] : nullptr;
+    }
+
+    bool Contains(const K& key) const {
+        return IsKeyAt(LowerBound(key), key);
+    }
+
+    size_t Count(const K& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    V& At(const K& key) {
+        V* value = Find(key);
+        if (value == nullptr) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "FlatMap::At: key not found");
+        }
+        return *value;
+    }
+
+    const V& At(const K& key) const {
+        const V* value = Find(key);
+        if (value == nullptr) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "FlatMap::At: key not found");
+        }
+        return *value;
+    }
+
+    // Значение по ключу; отсутствующий ключ вставляется со значением по умолчанию
+    V& operator[](const K& key) {
+        return *TryEmplace(key).first;
+    }
+
+    // Вставляет значение, сконструированное из args, если ключа ещё нет. Возвращает указатель
+    // на значение ключа и признак вставки. При исключении словарь не меняется
+    template <typename... Args>
+    std::pair<V*, bool> TryEmplace(const K& key, Args&&... args) {
+        const size_t index = LowerBound(key);
+        if (IsKeyAt(index, key)) {
+            return {&values_[index], false};
+        }
+        values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        VECTOR_TRY {
+            keys_.Insert(keys_.begin() + index, key);
+        } VECTOR_CATCH_ALL {
+            values_.Erase(values_.begin() + index);
+            VECTOR_RETHROW;
+        }
+        return {&values_[index], true};
+    }
+
+    std::pair<V*, bool> Insert(const K& key, const V& value) {
+        return TryEmplace(key, value);
+    }
+
+    std::pair<V*, bool> Insert(const K& key, V&& value) {
+        return TryEmplace(key, std::move(value));
+    }
+
+    // Вставляет или перезаписывает значение ключа
+    template <typename M>
+    std::pair<V*, bool> InsertOrAssign(const K& key, M&& value) {
+        const size_t index = LowerBound(key);
+        if (IsKeyAt(index, key)) {
+            values_[index] = std::forward<M>(value);
+            return {&values_[index], false};
+        }
+        return TryEmplace(key, std::forward<M>(value));
+    }
+
+    // Слияние с диапазоном пар (first, second), отсортированным по ключу, за один проход:
+    // O(Size() + N). Существующие ключи сохраняют свои значения (как в std::map::insert),
+    // из пар диапазона с одинаковым ключом берётся первая. При исключении словарь не меняется
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void InsertSorted(InputIt first, InputIt last) {
+        Vector<K> incoming_keys;
+        Vector<V> incoming_values;
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            incoming_keys.Reserve(count);
+            incoming_values.Reserve(count);
+        }
+        for (; first != last; ++first) {
+            incoming_keys.PushBack(first->first);
+            incoming_values.PushBack(first->second);
+        }
+        assert(std::is_sorted(incoming_keys.begin(), incoming_keys.end(), less_) &&
+               "InsertSorted: range is not sorted by key");
+        MergeSorted(incoming_keys, incoming_values);
+    }
+
+    size_t Erase(const K& key) {
+        const size_t index = LowerBound(key);
+        if (!IsKeyAt(index, key)) {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    void EraseAt(size_t index) {
+        assert(index < keys_.Size() && "FlatMap::EraseAt: index out of range");
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+    }
+
+    bool operator==(const FlatMap& other) const {
+        return keys_ == other.keys_ && values_ == other.values_;
+    }
+
+    bool operator!=(const FlatMap& other) const {
+        return !(*this == other);
+    }
+
+private:
+    bool IsKeyAt(size_t index, const K& key) const {
+        return index < keys_.Size() && !less_(key, keys_[index]);
+    }
+
+    // Как FlatSet::MergeSorted: пары переносятся, только если перенос и ключа, и значения
+    // не выбрасывает исключений
+    void MergeSorted(Vector<K>& incoming_keys, Vector<V>& incoming_values) {
+        constexpr bool MOVE = std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>;
+        const size_t capacity = keys_.Size() + incoming_keys.Size();
+        Vector<K> merged_keys;
+        Vector<V> merged_values;
+        merged_keys.Reserve(capacity);
+        merged_values.Reserve(capacity);
+        size_t i = 0;
+        for (size_t j = 0; j < incoming_keys.Size(); ++j) {
+            K& key = incoming_keys[j];
+            for (; i < keys_.Size() && less_(keys_[i], key); ++i) {
+                merged_keys.PushBack(vector_detail::Take<MOVE>(keys_[i]));
+                merged_values.PushBack(vector_detail::Take<MOVE>(values_[i]));
+            }
+            const bool present = (i < keys_.Size() && !less_(key, keys_[i]))
+                || (!merged_keys.Empty() && !less_(merged_keys.back(), key));
+            if (!present) {
+                merged_keys.PushBack(vector_detail::Take<MOVE>(key));
+                merged_values.PushBack(vector_detail::Take<MOVE>(incoming_values[j]));
+            }
+        }
+        for (; i < keys_.Size(); ++i) {
+            merged_keys.PushBack(vector_detail::Take<MOVE>(keys_[i]));
+            merged_values.PushBack(vector_detail::Take<MOVE>(values_[i]));
+        }
+        keys_.Swap(merged_keys);
+        values_.Swap(merged_values);
+    }
+
+    Vector<K> keys_;
+    Vector<V> values_;
+    [[no_unique_address]] Compare less_;
+};
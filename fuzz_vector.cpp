@@ -0,0 +1,411 @@
+// Дифференциальный фаззинг Vector: входные байты декодируются в последовательность операций,
+// которая выполняется одновременно над Vector и std::vector. После каждой операции содержимое
+// сравнивается, а вместимость проверяется по модели: рост в PushBack/Insert/GrowBy/копирующем
+// присваивании — по DoublingGrowth, Reserve и Resize — ровно до запрошенного, ShrinkToFit — до
+// размера, в остальных случаях вместимость не меняется. Каждая последовательность прогоняется
+// для int (тривиальные пути с memcpy/memmove) и для std::string.
+//
+// libFuzzer (Clang): cmake -DVECTOR_BUILD_FUZZ=ON, затем ./fuzz_vector corpus/
+// Без libFuzzer (VECTOR_FUZZ_STANDALONE) main прогоняет файлы и каталоги из аргументов, «-» —
+// стандартный ввод (для AFL: afl-fuzz -i in -o out -- ./fuzz_vector -), а без аргументов —
+// случайные входы с фиксированным зерном. В конце печатается пропускная способность, поэтому
+// корпус годится и как нагрузка для замеров производительности.
+
+#include "vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(VECTOR_FUZZ_STANDALONE)
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#endif
+
+namespace {
+
+// Ограничения, чтобы один вход не выделял гигабайты
+constexpr size_t MAX_SIZE = 512;
+constexpr size_t MAX_OPERATIONS = 4096;
+
+// Проверка, работающая и при NDEBUG: фаззер должен видеть падение
+void Expect(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "fuzz_vector: check failed: %s\n", what);
+        std::abort();
+    }
+}
+
+// Чтение входа; за концом данных возвращаются нули
+class ByteStream {
+public:
+    ByteStream(const uint8_t* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    bool Empty() const noexcept {
+        return position_ >= size_;
+    }
+
+    uint8_t Byte() noexcept {
+        return position_ < size_ ? data_[position_++] : 0;
+    }
+
+    // Число из [0, limit]
+    size_t Size(size_t limit) noexcept {
+        const size_t value = static_cast<size_t>(Byte()) | static_cast<size_t>(Byte()) << 8;
+        return value % (limit + 1);
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+int MakeValue(ByteStream& in, int /*tag*/) {
+    return static_cast<int>(static_cast<int8_t>(in.Byte()));
+}
+
+// Длина до 40 символов: и короткие строки с SSO, и строки в куче
+std::string MakeValue(ByteStream& in, std::string /*tag*/) {
+    const size_t length = in.Byte() % 41;
+    return std::string(length, static_cast<char>('a' + length % 26));
+}
+
+enum class Op : uint8_t {
+    PUSH_BACK,
+    PUSH_BACK_SELF,
+    EMPLACE_BACK,
+    POP_BACK,
+    INSERT,
+    INSERT_COUNT,
+    INSERT_RANGE,
+    APPEND,
+    GROW_BY,
+    ERASE,
+    ERASE_RANGE,
+    ERASE_IF,
+    RESIZE,
+    RESERVE,
+    SHRINK_TO_FIT,
+    CLEAR,
+    ASSIGN_COUNT,
+    COPY_ASSIGN,
+    COPY_CONSTRUCT,
+    MOVE_ASSIGN,
+    SWAP,
+    COUNT,
+};
+
+template <typename T>
+class Differential {
+public:
+    void Run(ByteStream in, size_t& operations) {
+        for (size_t step = 0; step < MAX_OPERATIONS && !in.Empty(); ++step) {
+            const uint8_t code = in.Byte();
+            const size_t i = code >> 7;
+            Apply(static_cast<Op>((code & 0x7f) % static_cast<uint8_t>(Op::COUNT)), mine_[i], ref_[i],
+                  mine_[1 - i], ref_[1 - i], in);
+            Compare(0);
+            Compare(1);
+            ++operations;
+        }
+    }
+
+private:
+    using Mine = Vector<T>;
+    using Ref = std::vector<T>;
+
+    static size_t Grown(size_t capacity, size_t required) {
+        return required <= capacity ? capacity : DoublingGrowth{}.NextCapacity(capacity, required, sizeof(T));
+    }
+
+    void Apply(Op op, Mine& v, Ref& r, Mine& other, Ref& other_ref, ByteStream& in) {
+        const size_t size = v.Size();
+        const size_t capacity = v.Capacity();
+        size_t expected = capacity;
+        switch (op) {
+            case Op::PUSH_BACK:
+                if (size < MAX_SIZE) {
+                    const T value = MakeValue(in, T{});
+                    v.PushBack(value);
+                    r.push_back(value);
+                    expected = Grown(capacity, size + 1);
+                }
+                break;
+            case Op::PUSH_BACK_SELF:
+                // Аргумент ссылается на элемент того же вектора, в том числе при реаллокации
+                if (size != 0 && size < MAX_SIZE) {
+                    const size_t index = in.Size(size - 1);
+                    v.PushBack(v[index]);
+                    r.push_back(T(r[index]));
+                    expected = Grown(capacity, size + 1);
+                }
+                break;
+            case Op::EMPLACE_BACK:
+                if (size < MAX_SIZE) {
+                    T value = MakeValue(in, T{});
+                    r.push_back(value);
+                    v.EmplaceBack(std::move(value));
+                    expected = Grown(capacity, size + 1);
+                }
+                break;
+            case Op::POP_BACK:
+                if (size != 0) {
+                    v.PopBack();
+                    r.pop_back();
+                }
+                break;
+            case Op::INSERT:
+                if (size < MAX_SIZE) {
+                    const size_t index = in.Size(size);
+                    const T value = MakeValue(in, T{});
+                    Expect(v.Insert(v.begin() + index, value) == v.begin() + index, "Insert result");
+                    r.insert(r.begin() + index, value);
+                    expected = Grown(capacity, size + 1);
+                }
+                break;
+            case Op::INSERT_COUNT: {
+                const size_t index = in.Size(size);
+                const size_t count = in.Size(MAX_SIZE - size);
+                const T value = MakeValue(in, T{});
+                Expect(v.Insert(v.begin() + index, count, value) == v.begin() + index, "Insert(count) result");
+                r.insert(r.begin() + index, count, value);
+                expected = Grown(capacity, size + count);
+                break;
+            }
+            case Op::INSERT_RANGE: {
+                // Диапазон из другого вектора: при вставке без реаллокации он не должен указывать на себя
+                const size_t index = in.Size(size);
+                const size_t count = std::min(other.Size(), MAX_SIZE - size);
+                v.Insert(v.begin() + index, other.begin(), other.begin() + count);
+                r.insert(r.begin() + index, other_ref.begin(), other_ref.begin() + count);
+                expected = Grown(capacity, size + count);
+                break;
+            }
+            case Op::APPEND: {
+                const size_t count = std::min(other.Size(), MAX_SIZE - size);
+                v.Append(other.begin(), other.begin() + count);
+                r.insert(r.end(), other_ref.begin(), other_ref.begin() + count);
+                expected = Grown(capacity, size + count);
+                break;
+            }
+            case Op::GROW_BY: {
+                // Часть слотов конструируется и фиксируется, остаток остаётся свободной вместимостью
+                const size_t count = in.Size(MAX_SIZE - size);
+                const size_t constructed = in.Size(count);
+                {
+                    auto guard = v.GrowBy(count);
+                    Expect(guard.Slots().Size() == count && guard.Slots().Data() == v.end(), "GrowBy slots");
+                    for (size_t k = 0; k < constructed; ++k) {
+                        const T value = MakeValue(in, T{});
+                        guard.Emplace(value);
+                        r.push_back(value);
+                    }
+                    if (in.Byte() % 4 != 0) {
+                        guard.Commit();
+                    } else {
+                        r.resize(size);
+                    }
+                }
+                expected = Grown(capacity, size + count);
+                break;
+            }
+            case Op::ERASE:
+                if (size != 0) {
+                    const size_t index = in.Size(size - 1);
+                    Expect(v.Erase(v.begin() + index) == v.begin() + index, "Erase result");
+                    r.erase(r.begin() + index);
+                }
+                break;
+            case Op::ERASE_RANGE: {
+                const size_t first = in.Size(size);
+                const size_t last = first + in.Size(size - first);
+                Expect(v.Erase(v.begin() + first, v.begin() + last) == v.begin() + first, "Erase(range) result");
+                r.erase(r.begin() + first, r.begin() + last);
+                break;
+            }
+            case Op::ERASE_IF: {
+                const T pivot = MakeValue(in, T{});
+                const auto predicate = [&pivot](const T& value) {
+                    return value < pivot;
+                };
+                const size_t removed = v.EraseIf(predicate);
+                const size_t ref_size = r.size();
+                r.erase(std::remove_if(r.begin(), r.end(), predicate), r.end());
+                Expect(removed == ref_size - r.size(), "EraseIf count");
+                break;
+            }
+            case Op::RESIZE: {
+                const size_t new_size = in.Size(MAX_SIZE);
+                v.Resize(new_size);
+                r.resize(new_size);
+                expected = std::max(capacity, new_size);
+                break;
+            }
+            case Op::RESERVE: {
+                const size_t new_capacity = in.Size(MAX_SIZE);
+                v.Reserve(new_capacity);
+                r.reserve(new_capacity);
+                expected = std::max(capacity, new_capacity);
+                break;
+            }
+            case Op::SHRINK_TO_FIT:
+                v.ShrinkToFit();
+                r.shrink_to_fit();
+                expected = size;
+                break;
+            case Op::CLEAR:
+                v.Clear();
+                r.clear();
+                break;
+            case Op::ASSIGN_COUNT: {
+                const size_t count = in.Size(MAX_SIZE);
+                const T value = MakeValue(in, T{});
+                v.Assign(count, value);
+                r.assign(count, value);
+                expected = std::max(capacity, count);
+                break;
+            }
+            case Op::COPY_ASSIGN:
+                v = other;
+                r = other_ref;
+                expected = Grown(capacity, other.Size());
+                break;
+            case Op::COPY_CONSTRUCT:
+                v = Mine(other);
+                r = Ref(other_ref);
+                expected = other.Size();
+                break;
+            case Op::MOVE_ASSIGN: {
+                const size_t other_capacity = other.Capacity();
+                const T* other_data = other.begin();
+                v = std::move(other);
+                r = std::move(other_ref);
+                Expect(v.begin() == other_data && other.Empty() && other.Capacity() == 0, "move keeps the buffer");
+                other_ref.clear();
+                expected = other_capacity;
+                break;
+            }
+            case Op::SWAP: {
+                const size_t other_capacity = other.Capacity();
+                v.Swap(other);
+                r.swap(other_ref);
+                Expect(other.Capacity() == capacity, "Swap exchanges capacities");
+                expected = other_capacity;
+                break;
+            }
+            case Op::COUNT:
+                break;
+        }
+        Expect(v.Capacity() == expected, "capacity follows the growth model");
+    }
+
+    void Compare(size_t i) const {
+        const Mine& v = mine_[i];
+        const Ref& r = ref_[i];
+        Expect(v.Size() == r.size(), "sizes match");
+        Expect(v.Size() <= v.Capacity(), "size <= capacity");
+        Expect(v.Empty() == (v.Size() == 0), "Empty");
+        Expect(v.end() - v.begin() == static_cast<std::ptrdiff_t>(v.Size()), "iterators span the size");
+        for (size_t k = 0; k < r.size(); ++k) {
+            Expect(v[k] == r[k], "elements match");
+        }
+    }
+
+    Mine mine_[2];
+    Ref ref_[2];
+};
+
+// Суммарная статистика прогонов для отчёта о пропускной способности
+struct Throughput {
+    size_t inputs = 0;
+    size_t bytes = 0;
+    size_t operations = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    ~Throughput() {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        if (inputs == 0 || seconds <= 0) {
+            return;
+        }
+        std::fprintf(stderr, "fuzz_vector: %zu inputs, %zu bytes, %zu operations, %.0f ops/s, %.2f MB/s\n", inputs,
+                     bytes, operations, static_cast<double>(operations) / seconds,
+                     static_cast<double>(bytes) / seconds / 1e6);
+    }
+};
+
+Throughput throughput;
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const auto start = std::chrono::steady_clock::now();
+    Differential<int>().Run(ByteStream(data, size), throughput.operations);
+    Differential<std::string>().Run(ByteStream(data, size), throughput.operations);
+    throughput.elapsed += std::chrono::steady_clock::now() - start;
+    ++throughput.inputs;
+    throughput.bytes += size;
+    return 0;
+}
+
+#if defined(VECTOR_FUZZ_STANDALONE)
+
+namespace {
+
+void RunInput(const std::vector<char>& input) {
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+void RunFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "fuzz_vector: cannot open " << path << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    RunInput(std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 1) {
+        // Случайные входы с фиксированным зерном: воспроизводимый прогон для ctest
+        std::mt19937 random(20240601);
+        for (int i = 0; i < 2000; ++i) {
+            std::vector<char> input(random() % 2048);
+            for (char& byte : input) {
+                byte = static_cast<char>(random());
+            }
+            RunInput(input);
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "-") {
+            RunInput(std::vector<char>(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()));
+        } else if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(arg)) {
+                if (entry.is_regular_file()) {
+                    RunFile(entry.path());
+                }
+            }
+        } else {
+            RunFile(arg);
+        }
+    }
+    std::cout << "All fuzz inputs passed!" << std::endl;
+}
+
+#endif  // VECTOR_FUZZ_STANDALONE
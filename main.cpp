@@ -1,10 +1,31 @@
+// Тесты проверяют и счётчики VectorStats, поэтому включают их до подключения vector.h
+#ifndef VECTOR_ENABLE_STATS
+#define VECTOR_ENABLE_STATS
+#endif
+
 #include "vector.h"
+#include "allocators.h"
+#include "memory_resource.h"
+#include "small_vector.h"
+#include "concurrent_vector.h"
+#include "stable_vector.h"
+#include "mapped_vector.h"
+#include "vector_io.h"
+#include "shared_vector.h"
+#include "flat_map.h"
 
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 namespace {
 
@@ -117,8 +138,80 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Аллокатор, подсчитывающий выделения и освобождения памяти
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        ++num_allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ++num_deallocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+
+    static void ResetCounters() {
+        num_allocations = 0;
+        num_deallocations = 0;
+    }
+
+    static inline int num_allocations = 0;
+    static inline int num_deallocations = 0;
+};
+
+// Дескриптор, включивший признак тривиальной перемещаемости.
+// Перемещения подсчитываются, чтобы убедиться, что реаллокация их не вызывает
+struct Handle {
+    Handle() = default;
+
+    explicit Handle(int value)
+        : value(std::make_unique<int>(value)) {
+    }
+
+    Handle(Handle&& other) noexcept
+        : value(std::move(other.value)) {
+        ++num_moved;
+    }
+
+    Handle& operator=(Handle&& other) noexcept {
+        value = std::move(other.value);
+        return *this;
+    }
+
+    ~Handle() {
+        ++num_destroyed;
+    }
+
+    std::unique_ptr<int> value;
+
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -733,6 +826,2109 @@ void TestFrontBack() {
     assert(cv.back() == "new_last");
 }
 
+void TestAllocators() {
+    {
+        CountingAllocator<int>::ResetCounters();
+        {
+            Vector<int, CountingAllocator<int>> v;
+            for (int i = 0; i < 10; ++i) {
+                v.PushBack(i);
+            }
+            // Вместимость растёт 1 -> 2 -> 4 -> 8 -> 16
+            assert(CountingAllocator<int>::num_allocations == 5);
+            assert(CountingAllocator<int>::num_deallocations == 4);
+            Vector<int, CountingAllocator<int>> v_copy(v);
+            assert(v_copy.Size() == v.Size());
+            assert(CountingAllocator<int>::num_allocations == 6);
+        }
+        assert(CountingAllocator<int>::num_allocations == CountingAllocator<int>::num_deallocations);
+    }
+    {
+        ArenaResource arena;
+        pmr::Vector<std::string> v(&arena);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(v.Size() == 100);
+        assert(v[42] == "42");
+        assert(v.GetAllocator().resource() == &arena);
+        assert(arena.BytesAllocated() >= v.Capacity() * sizeof(std::string));
+    }
+    {
+        // Первый блок арены на стеке: глобальная куча не используется
+        alignas(std::max_align_t) std::byte buffer[1024];
+        ArenaResource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        pmr::Vector<int> v(&arena);
+        v.Reserve(16);
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack(i);
+        }
+        const auto* first = reinterpret_cast<const std::byte*>(&v[0]);
+        assert(first >= buffer && first < buffer + sizeof(buffer));
+        v.Clear();
+    }
+    {
+        FixedPoolResource pool(64);
+        pmr::Vector<int> v1(&pool);
+        pmr::Vector<int> v2(&pool);
+        v1.PushBack(1);
+        v2.PushBack(2);
+        v1.Reserve(8);
+        v2.Reserve(8);
+        assert(v1[0] == 1 && v2[0] == 2);
+
+        // Блоки больше block_size обслуживаются upstream-ресурсом
+        v1.Reserve(1000);
+        assert(v1.Capacity() == 1000 && v1[0] == 1);
+    }
+    {
+        // Присваивание между векторами с разными ресурсами сохраняет ресурс получателя
+        ArenaResource arena1;
+        ArenaResource arena2;
+        pmr::Vector<int> v1(&arena1);
+        pmr::Vector<int> v2(&arena2);
+        for (int i = 0; i < 10; ++i) {
+            v1.PushBack(i);
+        }
+        v2 = v1;
+        assert(v2.Size() == 10 && v2[9] == 9);
+        assert(v2.GetAllocator().resource() == &arena2);
+
+        pmr::Vector<int> v3(&arena2);
+        v3 = std::move(v1);
+        assert(v3.Size() == 10 && v3[5] == 5);
+        assert(v3.GetAllocator().resource() == &arena2);
+        assert(v1.Empty());
+
+        pmr::Vector<int> v4(std::move(v3), &arena1);
+        assert(v4.Size() == 10 && v4.GetAllocator().resource() == &arena1);
+    }
+}
+
+void TestRelocation() {
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<std::unique_ptr<int>>);
+    static_assert(!IsTriviallyRelocatableV<std::string>);
+    static_assert(IsTriviallyRelocatableV<Handle>);
+    {
+        Handle::num_moved = 0;
+        Handle::num_destroyed = 0;
+        {
+            Vector<Handle> v;
+            for (int i = 0; i < 128; ++i) {
+                v.EmplaceBack(i);
+            }
+            assert(v.Size() == v.Capacity());
+            v.Emplace(v.begin() + 10, -1);
+            v.Reserve(1000);
+            assert(v.Size() == 129);
+            assert(*v[10].value == -1);
+            assert(*v[11].value == 10);
+            assert(*v[128].value == 127);
+            // Реаллокация переносит элементы побайтово, без перемещений и деструкторов
+            assert(Handle::num_moved == 0);
+            assert(Handle::num_destroyed == 0);
+        }
+        assert(Handle::num_destroyed == 129);
+    }
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(std::make_unique<int>(i));
+        }
+        v.Insert(v.begin(), std::make_unique<int>(-1));
+        assert(*v[0] == -1 && *v[10] == 9);
+    }
+}
+
+void TestSmallVector() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, 4> v;
+        assert(v.Capacity() == 4);
+        assert(v.IsInline());
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.IsInline());
+        assert(Obj::num_moved == 0);
+
+        // Переполнение встроенного буфера: ровно Size() перемещений
+        v.EmplaceBack(4);
+        assert(!v.IsInline());
+        assert(v.Capacity() == 8);
+        assert(Obj::num_moved == 4);
+        for (int i = 0; i < 5; ++i) {
+            assert(v[i].id == i);
+        }
+
+        v.Insert(v.cbegin() + 1, Obj{ID});
+        assert(v.Size() == 6 && v[1].id == ID && v[2].id == 1);
+        v.Erase(v.cbegin() + 1);
+        assert(v.Size() == 5 && v[1].id == 1);
+        assert(Obj::GetAliveObjectCount() == 5);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение в конструкторе не приводит к утечкам
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            SmallVector<Obj, 8> v(SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Reserve сохраняет вектор при исключении во время копирования
+        Obj::ResetCounters();
+        SmallVector<Obj, 8> v(SIZE);
+        v[SIZE / 2].throw_on_copy = true;
+        try {
+            SmallVector<Obj, 8> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        v.Reserve(SIZE * 2);
+        assert(v.Capacity() == SIZE * 2 && v.Size() == SIZE);
+        assert(Obj::num_copied == SIZE / 2);
+    }
+    {
+        // Копирующее присваивание во встроенный буфер копирует только rhs и при исключении
+        // оставляет вектор нетронутым, даже если перемещение элементов может бросать
+        struct CopyCountdown {
+            explicit CopyCountdown(int* copies_left)
+                : copies_left(copies_left) {
+            }
+            CopyCountdown(const CopyCountdown& other)
+                : copies_left(other.copies_left) {
+                if (--*copies_left < 0) {
+                    throw std::runtime_error("Oops");
+                }
+            }
+            CopyCountdown(CopyCountdown&& other)
+                : CopyCountdown(other) {
+            }
+            CopyCountdown& operator=(const CopyCountdown&) = default;
+            int* copies_left;
+        };
+        int copies_left = 1000;
+        SmallVector<CopyCountdown, 4> lhs;
+        lhs.EmplaceBack(&copies_left);
+        lhs.EmplaceBack(&copies_left);
+        SmallVector<CopyCountdown, 4> rhs;
+        for (int i = 0; i < 6; ++i) {
+            rhs.EmplaceBack(&copies_left);
+        }
+        copies_left = 3;
+        try {
+            lhs = rhs;
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(lhs.IsInline() && lhs.Size() == 2);
+
+        copies_left = 6;
+        lhs = rhs;
+        assert(!lhs.IsInline() && lhs.Size() == 6 && copies_left == 0);
+    }
+    {
+        SmallVector<std::string, 2> small;
+        small.PushBack("a");
+        SmallVector<std::string, 2> large;
+        for (int i = 0; i < 10; ++i) {
+            large.PushBack(std::to_string(i));
+        }
+        small.Swap(large);
+        assert(small.Size() == 10 && small[9] == "9");
+        assert(large.Size() == 1 && large[0] == "a" && large.IsInline());
+
+        SmallVector<std::string, 2> copy = small;
+        assert(copy.Size() == 10 && copy[5] == "5");
+        SmallVector<std::string, 2> moved = std::move(large);
+        assert(moved.Size() == 1 && moved[0] == "a" && large.Empty());
+        copy = moved;
+        assert(copy.Size() == 1 && copy[0] == "a");
+        moved = std::move(small);
+        assert(moved.Size() == 10 && moved.front() == "0" && moved.back() == "9");
+
+        moved.Resize(1);
+        moved.PopBack();
+        assert(moved.Empty());
+    }
+    {
+        SmallVector<TestObj, 1> v(1);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin(), v[1]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+}
+
+template <typename Growth>
+int CountGrowthAllocations(size_t count) {
+    CountingAllocator<int>::ResetCounters();
+    Vector<int, CountingAllocator<int>, Growth> v;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(static_cast<int>(i));
+        assert(v.Capacity() >= v.Size());
+    }
+    return CountingAllocator<int>::num_allocations;
+}
+
+void TestGrowthPolicies() {
+    const size_t SIZE = 1000;
+    assert(CountGrowthAllocations<DoublingGrowth>(SIZE) == 11);
+    assert(CountGrowthAllocations<FactorGrowth<>>(SIZE) == 18);
+    assert(CountGrowthAllocations<CacheLineGrowth<>>(SIZE) == 7);
+    {
+        FactorGrowth<> growth;
+        assert(growth.NextCapacity(0, 1, sizeof(int)) == 1);
+        assert(growth.NextCapacity(1, 2, sizeof(int)) == 2);
+        assert(growth.NextCapacity(10, 11, sizeof(int)) == 15);
+        assert(growth.NextCapacity(10, 100, sizeof(int)) == 100);
+    }
+    {
+        // 64-байтная кеш-линия вмещает 16 int
+        Vector<int, std::allocator<int>, CacheLineGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 16);
+    }
+    {
+        // После 1 КиБ вместимость растёт линейно на 256 байт
+        CappedGrowth<1024, 256> growth;
+        assert(growth.NextCapacity(128, 129, sizeof(int)) == 256);
+        assert(growth.NextCapacity(200, 201, sizeof(int)) == 256);
+        assert(growth.NextCapacity(256, 257, sizeof(int)) == 320);
+        assert(growth.NextCapacity(320, 1000, sizeof(int)) == 1000);
+
+        Vector<int, std::allocator<int>, CappedGrowth<1024, 256>> v;
+        for (int i = 0; i < 500; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 512);
+        assert(v[499] == 499);
+    }
+}
+
+template <typename T>
+bool IsAligned(const T* p, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+void TestAlignedAllocation() {
+    {
+        Vector<float, AlignedAllocator<float, 64>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(IsAligned(&v[0], 64));
+        }
+        assert(v[999] == 999.0f);
+    }
+    {
+        Vector<std::string, AlignedAllocator<std::string, 128>> v(3);
+        v[1] = "aligned";
+        v.Reserve(100);
+        assert(IsAligned(&v[0], 128));
+        assert(v[1] == "aligned");
+    }
+    {
+        // Рост за порог mmap и далее через mremap с сохранением содержимого
+        using Allocator = HugePageAllocator<std::uint64_t, 64, 1 << 16>;
+        static_assert(RawMemory<std::uint64_t, Allocator>::CAN_REALLOCATE);
+        Vector<std::uint64_t, Allocator> v;
+        const size_t SIZE = 1 << 18;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin() + 1, 42);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == 0 && v[1] == 42 && v[2] == 1 && v[SIZE] == SIZE - 1);
+        assert(IsAligned(&v[0], 64));
+
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == SIZE * 4 && v[SIZE] == SIZE - 1);
+        Vector<std::uint64_t, Allocator> v_copy(v);
+        assert(v_copy[SIZE] == SIZE - 1);
+    }
+    {
+        // Нетривиально перемещаемые типы растут обычным переносом
+        static_assert(!RawMemory<std::string, HugePageAllocator<std::string>>::CAN_REALLOCATE);
+        Vector<std::string, HugePageAllocator<std::string, 64, 4096>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(v[999] == "999");
+    }
+}
+
+void TestMallocAllocator() {
+    {
+        Vector<char, MallocAllocator<char>> v;
+        v.Reserve(1);
+        assert(v.Capacity() >= 1);
+#if defined(__GLIBC__) && !defined(VECTOR_USE_JEMALLOC)
+        // Вместимость равна фактическому размеру блока malloc
+        assert(v.Capacity() == malloc_usable_size(&*v.begin()));
+#endif
+        for (int i = 0; i < 10000; ++i) {
+            v.PushBack(static_cast<char>(i % 128));
+        }
+        v.Insert(v.begin() + 1, 'x');
+        assert(v.Size() == 10001 && v[0] == 0 && v[1] == 'x' && v[10000] == static_cast<char>(9999 % 128));
+        v.ShrinkToFit();
+        assert(v.Capacity() >= v.Size() && v[10000] == static_cast<char>(9999 % 128));
+    }
+    {
+        // Нетривиально перемещаемые типы растут переносом либо, с jemalloc, расширением блока
+        // на месте. Без jemalloc try_expand нет: запас блока malloc уже учтён allocate_at_least
+        static_assert(!RawMemory<std::string, MallocAllocator<std::string>>::CAN_REALLOCATE);
+#if defined(VECTOR_USE_JEMALLOC)
+        static_assert(HasTryExpand<MallocAllocator<std::string>>::value);
+#else
+        static_assert(!HasTryExpand<MallocAllocator<std::string>>::value);
+#endif
+        Vector<std::string, MallocAllocator<std::string>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        v.Insert(v.begin(), 3, "front");
+        assert(v.Size() == 1003 && v[2] == "front" && v[1002] == "999");
+    }
+#if defined(__GLIBC__) && !defined(VECTOR_USE_JEMALLOC)
+    {
+        // Запас блока, выделенного malloc, используется без реаллокации
+        VectorStats::Reset();
+        Vector<std::uint32_t, MallocAllocator<std::uint32_t>> v(1);
+        const size_t capacity = v.Capacity();
+        assert(capacity * sizeof(std::uint32_t) == malloc_usable_size(&*v.begin()));
+        while (v.Size() < capacity) {
+            v.PushBack(1);
+        }
+        assert(VectorStats::Snapshot().allocations == 1 && VectorStats::Snapshot().reallocations == 0);
+    }
+#endif
+#if defined(VECTOR_USE_JEMALLOC)
+    {
+        // Большой блок jemalloc расширяется xallocx за счёт следующих за ним страниц
+        size_t in_place = 0;
+        VectorStats::SetReallocationCallback(
+            [](const VectorReallocationEvent& event, void* context) noexcept {
+                *static_cast<size_t*>(context) += event.in_place ? 1 : 0;
+            },
+            &in_place);
+        Vector<std::string, MallocAllocator<std::string>> v;
+        v.Reserve(size_t{1} << 16);
+        v.EmplaceBack("first");
+        for (int i = 0; i < 16 && in_place == 0; ++i) {
+            v.Reserve(v.Capacity() + 4096);
+        }
+        VectorStats::SetReallocationCallback(nullptr);
+        assert(in_place > 0 && v[0] == "first");
+    }
+#endif
+}
+
+template <typename T, typename Alloc>
+bool Equals(const Vector<T, Alloc>& v, std::initializer_list<T> expected) {
+    return v.Size() == expected.size() && std::equal(v.begin(), v.end(), expected.begin());
+}
+
+void TestVectorAlgorithms() {
+    {
+        // Размеры и смещения, при которых векторные циклы проходят пролог, основную часть и хвост
+        Vector<int, AlignedAllocator<int, 64>> v(100);
+        v.Iota(-50);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i) - 50);
+        }
+        for (size_t offset = 0; offset < 9; ++offset) {
+            for (size_t length = 0; offset + length <= v.Size(); length += 7) {
+                const int* first = v.begin() + offset;
+                const int* last = first + length;
+                for (int value : {-50, -45, 0, 49, 100}) {
+                    assert(vector_simd::Find(first, last, value) == std::find(first, last, value));
+                    assert(vector_simd::Count(first, last, value) ==
+                           static_cast<size_t>(std::count(first, last, value)));
+                }
+                int sum = 0;
+                for (const int* p = first; p != last; ++p) {
+                    sum += *p;
+                }
+                assert(vector_simd::Sum(first, last) == sum);
+                if (length > 0) {
+                    const auto [min_it, max_it] = std::minmax_element(first, last);
+                    assert(vector_simd::MinMax(first, last) == std::make_pair(*min_it, *max_it));
+                }
+            }
+        }
+
+        assert(v.Contains(0) && !v.Contains(50));
+        assert(v.Find(10) == v.begin() + 60 && *v.Find(10) == 10);
+        assert(v.MinMax() == std::make_pair(-50, 49));
+        assert(v.Sum() == -50);
+
+        v.Fill(7);
+        assert(v.Count(7) == 100 && v.Sum() == 700);
+    }
+    {
+        // Беззнаковые сравниваются без знака
+        Vector<uint32_t> v(33, 1);
+        v[20] = 0xFFFFFFFFu;
+        v[5] = 0;
+        assert(v.MinMax() == std::make_pair(0u, 0xFFFFFFFFu));
+    }
+    {
+        Vector<float> v(37);
+        v.Iota(0.5f);
+        assert(v[36] == 36.5f && v.Sum() == 684.5f);
+        assert(v.MinMax() == std::make_pair(0.5f, 36.5f));
+        v[30] = -0.0f;
+        assert(v.Find(0.0f) == v.begin() + 30);
+        assert(v.Count(1.5f) == 1 && !v.Contains(100.0f));
+    }
+    {
+        // Для прочих типов используются обычные алгоритмы
+        Vector<std::string> v{"b", "a", "c", "a"};
+        assert(v.Count("a") == 2 && v.Find("c") == v.begin() + 2);
+        assert(v.MinMax() == std::make_pair(std::string("a"), std::string("c")));
+        assert(v.Sum() == "baca");
+        v.Fill("z");
+        assert(v.Count("z") == 4);
+    }
+    {
+        Vector<int> a{1, 2, 3};
+        Vector<int> b{1, 2, 3};
+        Vector<int> c{1, 2, 4};
+        Vector<int> d{1, 2};
+        assert(a == b && !(a != b));
+        assert(a != c && a < c && c > a && a <= b && a >= b);
+        assert(d < a && d != a);
+        assert(Vector<int>() == Vector<int>());
+
+        Vector<double> x{1.0, 0.0};
+        Vector<double> y{1.0, -0.0};
+        assert(x == y);
+        Vector<std::string> s1{"x", "y"};
+        Vector<std::string> s2{"x", "z"};
+        assert(s1 != s2 && s1 < s2);
+    }
+}
+
+struct ExternalBuffers {
+    int freed = 0;
+    size_t last_capacity = 0;
+};
+
+void FreeExternalBuffer(std::byte* buffer, size_t capacity, void* context) noexcept {
+    auto* buffers = static_cast<ExternalBuffers*>(context);
+    ++buffers->freed;
+    buffers->last_capacity = capacity;
+    std::free(buffer);
+}
+
+void TestAdoptRelease() {
+    using Deleter = BufferDeleter<std::byte>;
+    ExternalBuffers buffers;
+    {
+        // Буфер, принятый без копирования, освобождается своим deleter
+        auto* dma = static_cast<std::byte*>(std::malloc(64));
+        std::memset(dma, 7, 16);
+        Vector<std::byte> v;
+        v.Adopt(dma, 16, 64, Deleter{&FreeExternalBuffer, &buffers});
+        assert(v.begin() == dma && v.Size() == 16 && v.Capacity() == 64);
+        assert(v[15] == std::byte{7});
+        v.PushBack(std::byte{1});
+        assert(v.begin() == dma && v[16] == std::byte{1});
+    }
+    assert(buffers.freed == 1 && buffers.last_capacity == 64);
+    {
+        // Рост сверх вместимости переносит элементы в память аллокатора и освобождает внешний буфер
+        auto* dma = static_cast<std::byte*>(std::malloc(4));
+        std::memset(dma, 3, 4);
+        Vector<std::byte> v;
+        v.Adopt(dma, 4, 4, Deleter{&FreeExternalBuffer, &buffers});
+        v.PushBack(std::byte{9});
+        assert(buffers.freed == 2 && v.begin() != dma);
+        assert(v.Size() == 5 && v[3] == std::byte{3} && v[4] == std::byte{9});
+
+        // Release отдаёт буфер аллокатора вместе с функцией освобождения
+        std::byte* data = v.begin();
+        const size_t capacity = v.Capacity();
+        ReleasedBuffer<std::byte> released = v.Release();
+        assert(v.Empty() && v.Capacity() == 0);
+        assert(released.data == data && released.size == 5 && released.capacity == capacity);
+        assert(released.deleter);
+
+        // Буфер можно вернуть в вектор или освободить через deleter
+        Vector<std::byte> w;
+        w.Adopt(released.data, released.size, released.capacity);
+        assert(w.Size() == 5 && w[4] == std::byte{9});
+        released = w.Release();
+        released.deleter(released.data, released.capacity);
+    }
+    {
+        // Внешний буфер переходит дальше вместе со своим deleter
+        auto* dma = static_cast<std::byte*>(std::malloc(8));
+        Vector<std::byte> v;
+        v.Adopt(dma, 0, 8, Deleter{&FreeExternalBuffer, &buffers});
+        Vector<std::byte> moved(std::move(v));
+        ReleasedBuffer<std::byte> released = moved.Release();
+        assert(released.data == dma && released.deleter.context == &buffers);
+        released.deleter(released.data, released.capacity);
+        assert(buffers.freed == 3 && buffers.last_capacity == 8);
+    }
+    {
+        // Нетривиальные элементы переживают Adopt и Release
+        Vector<std::string> v{"a", "b"};
+        ReleasedBuffer<std::string> released = v.Release();
+        Vector<std::string> w;
+        w.Adopt(released.data, released.size, released.capacity);
+        assert(w.Size() == 2 && w[1] == "b");
+        w.PushBack("c");
+        assert(w.Size() == 3 && w[0] == "a");
+    }
+}
+
+void TestMappedVector() {
+    char path[] = "/tmp/mapped_vector_XXXXXX";
+    const int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    {
+        MappedVector<uint64_t> v(path, MappedMode::READ_WRITE);
+        assert(v.IsWritable() && v.Empty() && v.Capacity() == 0);
+        for (uint64_t i = 0; i < 10000; ++i) {
+            v.PushBack(i * 3);
+        }
+        assert(v.Size() == 10000 && v.Capacity() >= 10000);
+        assert(v[9999] == 29997 && v.back() == 29997);
+        assert(v.Contains(300) && v.Count(301) == 0);
+        v.Advise(AccessHint::SEQUENTIAL);
+        v.Flush();
+    }
+    {
+        // Запас вместимости отрезан при закрытии, данные читаются без копирования
+        MappedVector<uint64_t> v(path);
+        assert(!v.IsWritable() && v.Size() == 10000 && v.Capacity() == 10000);
+        assert(v.front() == 0 && v.At(5000) == 15000);
+        assert(v.MinMax() == std::make_pair(uint64_t{0}, uint64_t{29997}));
+        MappedVector<uint64_t> moved(std::move(v));
+        assert(!v.IsOpen() && moved.Size() == 10000);
+    }
+    {
+        MappedVector<uint64_t> v(path, MappedMode::READ_WRITE);
+        v.Resize(20000);
+        assert(v[19999] == 0 && v[9999] == 29997);
+        v.Resize(3);
+    }
+    {
+        MappedVector<uint64_t> v(path);
+        assert(v.Size() == 3 && v[2] == 6);
+    }
+    {
+        // Размер файла не кратен размеру элемента
+        MappedVector<uint32_t> bytes(path, MappedMode::READ_WRITE);
+        bytes.Resize(5);
+    }
+    try {
+        MappedVector<uint64_t> v(path);
+        assert(false);
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::invalid_argument);
+    }
+    std::remove(path);
+    try {
+        MappedVector<int> v(path);
+        assert(false);
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+
+    // Отказ отображения после удлинения файла возвращает файл к прежней длине. Нужна файловая
+    // система, допускающая разреженный файл больше адресного пространства (tmpfs)
+    char shm_path[] = "/dev/shm/mapped_vector_XXXXXX";
+    const int shm_fd = mkstemp(shm_path);
+    if (shm_fd >= 0) {
+        const bool sparse = ftruncate(shm_fd, off_t{1} << 50) == 0 && ftruncate(shm_fd, 0) == 0;
+        close(shm_fd);
+        if (sparse) {
+            {
+                MappedVector<uint64_t> v(shm_path, MappedMode::READ_WRITE);
+                v.Resize(0);
+                for (uint64_t i = 0; i < 512; ++i) {
+                    v.PushBack(i);
+                }
+                try {
+                    v.Reserve(size_t{1} << 47);
+                    assert(false && "Exception is expected");
+                } catch (const std::system_error&) {
+                }
+                assert(v.Size() == 512 && v.Capacity() == 512 && v[511] == 511);
+            }
+            MappedVector<uint64_t> v(shm_path);
+            assert(v.Size() == 512);
+        }
+        std::remove(shm_path);
+    }
+}
+
+struct IoRecord {
+    uint32_t id;
+    double value;
+};
+
+void TestVectorIo() {
+    {
+        // Тривиально копируемые элементы: заголовок и данные одним блоком
+        Vector<IoRecord> records;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            records.PushBack({i, i * 0.25});
+        }
+        std::stringstream stream;
+        WriteTo(records, stream);
+        assert(stream.str().size() == sizeof(VectorIoHeader) + 1000 * sizeof(IoRecord));
+
+        Vector<IoRecord> loaded{{7, 7.0}};
+        ReadFrom(loaded, stream);
+        assert(loaded.Size() == 1000 && loaded.Capacity() == 1000);
+        assert(loaded[999].id == 999 && loaded[999].value == 999 * 0.25);
+
+        // Инкрементальное чтение порциями, разрезающими заголовок и записи
+        const std::string bytes = stream.str() + "next message";
+        Vector<IoRecord> incremental;
+        VectorReader<IoRecord> reader(incremental);
+        size_t consumed = 0;
+        for (size_t pos = 0; pos < bytes.size() && !reader.Done(); pos += 7) {
+            const size_t portion = std::min<size_t>(7, bytes.size() - pos);
+            consumed += reader.Feed(bytes.data() + pos, portion);
+        }
+        assert(reader.Done() && consumed == bytes.size() - std::strlen("next message"));
+        assert(incremental.Size() == 1000 && incremental[500].id == 500);
+    }
+    {
+        // Элементы с кодеком пишутся блоками
+        Vector<std::string> words;
+        for (int i = 0; i < 20000; ++i) {
+            words.PushBack(std::string(static_cast<size_t>(i % 17), 'a' + static_cast<char>(i % 26)));
+        }
+        std::stringstream stream;
+        WriteTo(words, stream);
+        Vector<std::string> loaded;
+        ReadFrom(loaded, stream);
+        assert(loaded == words);
+
+        const std::string bytes = stream.str();
+        Vector<std::string> incremental{"kept"};
+        VectorReader<std::string> reader(incremental);
+        for (size_t pos = 0; pos < bytes.size(); pos += 4096) {
+            reader.Feed(bytes.data() + pos, std::min<size_t>(4096, bytes.size() - pos));
+        }
+        assert(reader.Done() && incremental.Size() == words.Size() + 1);
+        assert(incremental[0] == "kept" && incremental.back() == words.back());
+
+        Vector<Vector<std::string>> nested{{"a", "b"}, {}, {"c"}};
+        std::stringstream nested_stream;
+        WriteTo(nested, nested_stream);
+        Vector<Vector<std::string>> nested_loaded;
+        ReadFrom(nested_loaded, nested_stream);
+        assert(nested_loaded == nested);
+    }
+    {
+        // Файловый дескриптор: writev и одно чтение в буфер
+        char path[] = "/tmp/vector_io_XXXXXX";
+        const int fd = mkstemp(path);
+        assert(fd >= 0);
+        Vector<int> v(100000);
+        v.Iota(1);
+        WriteTo(v, fd);
+        lseek(fd, 0, SEEK_SET);
+        Vector<int> loaded;
+        ReadFrom(loaded, fd);
+        assert(loaded == v);
+        close(fd);
+        std::remove(path);
+    }
+    {
+        // Повреждённые и несовместимые данные
+        Vector<int> v{1, 2, 3};
+        std::stringstream stream;
+        WriteTo(v, stream);
+        const std::string bytes = stream.str();
+
+        const auto fails = [](const std::string& data, auto target) {
+            std::stringstream in(data);
+            try {
+                ReadFrom(target, in);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        assert(fails(bytes.substr(0, bytes.size() - 1), Vector<int>()));
+        assert(fails(bytes, Vector<int64_t>()));
+        assert(fails(bytes, Vector<std::string>()));
+        assert(fails("garbage garbage garbage!", Vector<int>()));
+
+        // 48 байт, объявляющие 2^33 строк в одном блоке: запрет до резервирования памяти
+        VectorIoHeader header{VECTOR_IO_MAGIC, VECTOR_IO_VERSION, 0, sizeof(std::string), uint64_t{1} << 33};
+        const VectorIoChunkHeader chunk{8, uint64_t{1} << 33};
+        std::string corrupt(reinterpret_cast<const char*>(&header), sizeof(header));
+        corrupt.append(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+        corrupt.append(8, '\0');
+        assert(corrupt.size() == 48);
+        assert(fails(corrupt, Vector<std::string>()));
+
+        Vector<std::string> target;
+        VectorReader<std::string> reader(target);
+        try {
+            reader.Feed(corrupt.data(), corrupt.size());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(target.Capacity() == 0);
+
+        // Обратный случай — заголовки блока с огромным bytes: отказ без выделения памяти
+        const auto chunk_message = [](uint64_t bytes) {
+            const VectorIoHeader string_header{VECTOR_IO_MAGIC, VECTOR_IO_VERSION, 0, sizeof(std::string), 1};
+            const VectorIoChunkHeader huge_chunk{bytes, 1};
+            std::string message(reinterpret_cast<const char*>(&string_header), sizeof(string_header));
+            message.append(reinterpret_cast<const char*>(&huge_chunk), sizeof(huge_chunk));
+            return message;
+        };
+        VectorStats::Reset();
+        assert(fails(chunk_message(uint64_t{1} << 44), Vector<std::string>()));
+        assert(fails(chunk_message(uint64_t{1} << 30), Vector<std::string>()));
+        assert(fails(chunk_message(VectorIoLimits::DEFAULT_MAX_CHUNK_BYTES + 1), Vector<std::string>()));
+
+        Vector<std::string> chunk_target;
+        VectorReader<std::string> chunk_reader(chunk_target);
+        const std::string huge = chunk_message(uint64_t{1} << 44);
+        try {
+            chunk_reader.Feed(huge.data(), huge.size());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+
+        // С увеличенным пределом тело читается частями: до конца данных выделено не больше окна
+        VectorIoLimits limits;
+        limits.max_chunk_bytes = size_t{1} << 30;
+        std::stringstream truncated(chunk_message(uint64_t{1} << 30) + "partial");
+        try {
+            ReadFrom(chunk_target, truncated, limits);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+
+        // RAW-заголовок с 2^42 элементами: память растёт по мере прихода данных
+        const VectorIoHeader raw_header{VECTOR_IO_MAGIC, VECTOR_IO_VERSION, VECTOR_IO_RAW, sizeof(IoRecord),
+                                        uint64_t{1} << 42};
+        std::string raw(reinterpret_cast<const char*>(&raw_header), sizeof(raw_header));
+        raw.append(3 * sizeof(IoRecord), '\0');
+        assert(fails(raw, Vector<IoRecord>()));
+        assert(VectorStats::Snapshot().peak_capacity_bytes <= 2 * (size_t{64} << 10));
+
+        // Версию 0 писатель не создаёт
+        std::string zero = bytes;
+        const uint16_t zero_version = 0;
+        std::memcpy(zero.data() + offsetof(VectorIoHeader, version), &zero_version, sizeof(zero_version));
+        assert(!fails(bytes, Vector<int>()) && fails(zero, Vector<int>()));
+    }
+    {
+        // Доверенный размер: одно резервирование под всё сообщение
+        Vector<uint32_t> v(100000);
+        v.Iota(0);
+        std::stringstream stream;
+        WriteTo(v, stream);
+        VectorIoLimits limits;
+        limits.trusted_count = v.Size();
+        Vector<uint32_t> loaded;
+        VectorStats::Reset();
+        ReadFrom(loaded, stream, limits);
+        assert(loaded == v && loaded.Capacity() == v.Size());
+        assert(VectorStats::Snapshot().allocations == 1);
+
+        stream.clear();
+        stream.seekg(0);
+        Vector<uint32_t> windowed;
+        VectorStats::Reset();
+        ReadFrom(windowed, stream);
+        assert(windowed == v && windowed.Capacity() == v.Size());
+        assert(VectorStats::Snapshot().allocations > 1);
+    }
+}
+
+void TestRangeInsertion() {
+    {
+        Vector<int> v{1, 2, 3};
+        assert(Equals(v, {1, 2, 3}));
+        assert(v.Capacity() == 3);
+
+        const std::list<int> l{7, 8};
+        Vector<int> from_list(l.begin(), l.end());
+        assert(Equals(from_list, {7, 8}));
+
+        Vector<int> filled(3, 5);
+        assert(Equals(filled, {5, 5, 5}));
+
+        // Insert(pos, count, value) не путается с перегрузкой для диапазона
+        filled.Insert(filled.begin() + 1, 2, 9);
+        assert(Equals(filled, {5, 9, 9, 5, 5}));
+    }
+    {
+        // Одна реаллокация на пакет, независимо от его размера
+        CountingAllocator<int>::ResetCounters();
+        Vector<int, CountingAllocator<int>> v;
+        std::vector<int> chunk(10'000);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            chunk[i] = static_cast<int>(i);
+        }
+        v.Append(chunk.begin(), chunk.end());
+        assert(CountingAllocator<int>::num_allocations == 1);
+        assert(v.Size() == chunk.size() && v[9'999] == 9'999);
+        v.Append(chunk.begin(), chunk.end());
+        assert(CountingAllocator<int>::num_allocations == 2);
+        assert(v.Size() == 2 * chunk.size() && v[10'000] == 0);
+    }
+    {
+        // Вставка в середину без реаллокации: короткий и длинный по сравнению с хвостом диапазон
+        Vector<std::string> v{"a", "b", "c", "d"};
+        v.Reserve(20);
+        const std::vector<std::string> two{"x", "y"};
+        auto pos = v.Insert(v.begin() + 1, two.begin(), two.end());
+        assert(pos == v.begin() + 1);
+        assert(v.Size() == 6);
+        assert(v[0] == "a" && v[1] == "x" && v[2] == "y" && v[3] == "b" && v[5] == "d");
+
+        const std::vector<std::string> many{"1", "2", "3", "4", "5"};
+        v.Insert(v.end() - 1, many.begin(), many.end());
+        assert(v.Size() == 11);
+        assert(v[4] == "c" && v[5] == "1" && v[9] == "5" && v[10] == "d");
+        assert(v.Capacity() == 20);
+
+        v.Insert(v.begin(), 3, v[10]);
+        assert(v.Size() == 14 && v[0] == "d" && v[2] == "d" && v[3] == "a" && v[13] == "d");
+        v.Insert(v.begin() + 13, 5, "z");
+        assert(v.Size() == 19 && v[12] == "5" && v[13] == "z" && v[17] == "z" && v[18] == "d");
+    }
+    {
+        // Реаллокация при вставке диапазона: по одному переносу на старый элемент
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        std::vector<Obj> src(5);
+        const int copies_before = Obj::num_copied;
+        const int moves_before = Obj::num_moved;
+        v.Insert(v.begin() + 3, src.begin(), src.end());
+        assert(v.Size() == 15);
+        assert(v.Capacity() == 20);
+        assert(Obj::num_copied - copies_before == 5);
+        assert(Obj::num_moved - moves_before == 10);
+    }
+    {
+        // Input-итераторы
+        std::istringstream in("4 5 6");
+        Vector<int> v{1, 2, 3};
+        v.Insert(v.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+        assert(Equals(v, {1, 4, 5, 6, 2, 3}));
+    }
+    {
+        Vector<int> v{1, 2, 3, 4, 5};
+        const size_t capacity = v.Capacity();
+        v.Assign({7, 8});
+        assert(Equals(v, {7, 8}) && v.Capacity() == capacity);
+        v.Assign(4, 1);
+        assert(Equals(v, {1, 1, 1, 1}) && v.Capacity() == capacity);
+        v = {1, 2, 3, 4, 5, 6, 7};
+        assert(Equals(v, {1, 2, 3, 4, 5, 6, 7}));
+        v.Assign(2, v[6]);
+        assert(Equals(v, {7, 7}));
+
+        Obj::ResetCounters();
+        Vector<Obj> objs(5);
+        std::vector<Obj> src(3);
+        objs.Assign(src.begin(), src.end());
+        assert(objs.Size() == 3);
+        assert(Obj::num_assigned == 3 && Obj::num_copied == 0);
+    }
+    {
+        // Assign с реаллокацией сохраняет состояние политики роста: серия очисток продолжается
+        Vector<int, std::allocator<int>, TrimmingGrowth<DoublingGrowth, 4, 2>> v;
+        v.Reserve(100);
+        v.PushBack(1);
+        v.Clear();
+        const std::list<int> values(150, 2);
+        v.Assign(values.begin(), values.end());
+        assert(v.Size() == 150 && v.Capacity() >= 150 && v[149] == 2);
+        v.Resize(10);
+        v.Clear();
+        assert(v.Capacity() == 10);
+
+        v.Reserve(100);
+        v.Clear();
+        v.Assign(300, 3);
+        assert(v.Size() == 300 && v[299] == 3);
+        v.Resize(10);
+        v.Clear();
+        assert(v.Capacity() == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void TestRangeErase() {
+    {
+        Vector<int> v{0, 1, 2, 3, 4, 5, 6, 7};
+        auto pos = v.Erase(v.begin() + 2, v.begin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(Equals(v, {0, 1, 5, 6, 7}));
+        assert(v.Erase(v.begin(), v.begin()) == v.begin() && v.Size() == 5);
+        v.Erase(v.begin() + 3, v.end());
+        assert(Equals(v, {0, 1, 5}));
+
+        assert(v.UnorderedErase(v.begin()) == v.begin());
+        assert(Equals(v, {5, 1}));
+        v.UnorderedErase(v.begin() + 1);
+        assert(Equals(v, {5}));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        for (int i = 0; i < 10; ++i) {
+            v[i].id = i;
+        }
+        const int destroyed_before = Obj::num_destroyed;
+        v.Erase(v.begin() + 1, v.begin() + 4);
+        assert(v.Size() == 7);
+        assert(v[0].id == 0 && v[1].id == 4 && v[6].id == 9);
+        assert(Obj::num_move_assigned == 6);
+        assert(Obj::num_destroyed - destroyed_before == 3);
+
+        // Удаление нечётных за один проход
+        assert(v.EraseIf([](const Obj& obj) {
+            return obj.id % 2 == 1;
+        }) == 3);
+        assert(v.Size() == 4);
+        assert(v[0].id == 0 && v[1].id == 4 && v[2].id == 6 && v[3].id == 8);
+
+        v.UnorderedErase(v.begin() + 1);
+        assert(v.Size() == 3 && v[1].id == 8);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Тривиально перемещаемые элементы: удаление без перемещений
+        Handle::num_moved = 0;
+        Handle::num_destroyed = 0;
+        Vector<Handle> v;
+        v.Reserve(100);
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.EraseIf([](const Handle& h) {
+            return *h.value % 3 == 0;
+        }) == 34);
+        assert(v.Size() == 66);
+        assert(*v[0].value == 1 && *v[1].value == 2 && *v[2].value == 4 && *v[65].value == 98);
+        v.Erase(v.begin(), v.begin() + 6);
+        assert(*v[0].value == 10);
+        v.UnorderedErase(v.begin());
+        assert(*v[0].value == 98 && v.Size() == 59);
+        assert(Handle::num_moved == 0);
+        assert(Handle::num_destroyed == 41);
+
+        // Исключение в предикате не оставляет разрушенных элементов внутри вектора
+        int checked = 0;
+        try {
+            v.EraseIf([&checked](const Handle& h) {
+                if (++checked == 10) {
+                    throw std::runtime_error("Oops");
+                }
+                return *h.value % 2 == 0;
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() < 59 && v.Size() > 59 - 10);
+        for (const Handle& h : v) {
+            assert(h.value != nullptr);
+        }
+    }
+    {
+        Vector<std::string> v{"keep", "drop", "keep", "drop"};
+        assert(v.EraseIf([](const std::string& str) {
+            return str == "drop";
+        }) == 2);
+        assert(v.Size() == 2 && v[0] == "keep" && v[1] == "keep");
+    }
+}
+
+void TestDefaultInit() {
+    const size_t SIZE = 1000;
+    {
+        Vector<std::uint8_t> buffer(SIZE, default_init);
+        assert(buffer.Size() == SIZE && buffer.Capacity() == SIZE);
+        std::fill(buffer.begin(), buffer.end(), 7);
+
+        buffer.ResizeUninitialized(SIZE / 2);
+        buffer.ResizeUninitialized(SIZE * 4);
+        assert(buffer.Size() == SIZE * 4);
+        assert(buffer[SIZE / 2 - 1] == 7);
+        std::fill(buffer.begin() + SIZE / 2, buffer.end(), 9);
+        assert(buffer[SIZE * 4 - 1] == 9);
+    }
+    {
+        // Нетривиальные типы инициализируются конструктором по умолчанию
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(Obj::num_default_constructed == SIZE * 2);
+        v.ResizeDefaultInit(1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            Vector<Obj> v(SIZE, default_init);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void TestShrinkToFit() {
+    {
+        Vector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 128);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 100 && v[99] == 99);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 9);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+
+        v.Assign(5, 1);
+        v.ReleaseMemory();
+        assert(v.Empty() && v.Capacity() == 0);
+    }
+    {
+        // Элементы с noexcept-перемещением перемещаются, а не копируются
+        Obj::ResetCounters();
+        std::vector<Obj> src(10);
+        Vector<Obj> v(src.begin(), src.end());
+        v.Reserve(20);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v.Size() == 10);
+        assert(Obj::num_copied == 10);
+        assert(Obj::GetAliveObjectCount() == 20);
+    }
+    {
+        // Вместимость уменьшается после серии «маленьких» Clear до максимума этой серии
+        Vector<int, std::allocator<int>, TrimmingGrowth<DoublingGrowth, 4, 3>> v;
+        v.Resize(1000);
+        v.Clear();
+        assert(v.Capacity() == 1000);
+        for (size_t size : {10, 50, 20}) {
+            assert(v.Capacity() == 1000);
+            v.Resize(size);
+            v.Clear();
+        }
+        assert(v.Capacity() == 50);
+
+        // Крупный размер сбрасывает серию
+        v.Resize(40);
+        v.Clear();
+        v.Resize(5);
+        v.Clear();
+        assert(v.Capacity() == 50);
+    }
+    {
+        // Перемещающее присваивание не считается очисткой и ничего не выделяет
+        using Trimming = Vector<int, std::allocator<int>, TrimmingGrowth<>>;
+        std::vector<Trimming> sources(20);
+        for (Trimming& source : sources) {
+            source.Reserve(1024);
+            source.PushBack(1);
+        }
+        Trimming v;
+        VectorStats::Reset();
+        for (Trimming& source : sources) {
+            v = std::move(source);
+        }
+        assert(VectorStats::Snapshot().allocations == 0);
+        assert(v.Capacity() == 1024 && v.Size() == 1);
+
+        // Состояние политики переходит при перемещении: серия очисток продолжается
+        Trimming w;
+        w.Reserve(1024);
+        for (int i = 0; i < 15; ++i) {
+            w.PushBack(i);
+            w.Clear();
+        }
+        Trimming moved(std::move(w));
+        moved.PushBack(1);
+        moved.Clear();
+        assert(moved.Capacity() < 1024);
+
+        Trimming x;
+        x.Reserve(1024);
+        for (int i = 0; i < 15; ++i) {
+            x.PushBack(i);
+            x.Clear();
+        }
+        Trimming assigned;
+        assigned = std::move(x);
+        assigned.PushBack(1);
+        assigned.Clear();
+        assert(assigned.Capacity() < 1024);
+    }
+}
+
+void TestStats() {
+    static_assert(VectorStats::Enabled());
+    {
+        // Рост удвоением: 1, 2, 4, 8 — четыре выделения и три реаллокации с переносом
+        VectorStats::Reset();
+        {
+            Vector<int> v;
+            for (int i = 0; i < 5; ++i) {
+                v.PushBack(i);
+            }
+            const VectorStatsSnapshot stats = VectorStats::Snapshot();
+            assert(stats.allocations == 4 && stats.deallocations == 3);
+            assert(stats.bytes_allocated == (1 + 2 + 4 + 8) * sizeof(int));
+            assert(stats.reallocations == 3);
+            assert(stats.elements_relocated_bitwise == 1 + 2 + 4);
+            assert(stats.elements_moved == 0 && stats.elements_copied == 0);
+            assert(stats.peak_capacity_bytes == 8 * sizeof(int));
+            assert(stats.live_bytes == 8 * sizeof(int));
+        }
+        // При разрушении три незанятых элемента из восьми учитываются как потерянная вместимость
+        const VectorStatsSnapshot stats = VectorStats::Snapshot();
+        assert(stats.deallocations == 4 && stats.live_bytes == 0);
+        assert(stats.wasted_capacity_bytes == 3 * sizeof(int));
+        assert(stats.peak_live_bytes == (4 + 8) * sizeof(int));
+    }
+    {
+        // Перемещение выбирается для noexcept-типов, копирование — для остальных
+        Vector<std::string> strings(4);
+        VectorStats::Reset();
+        strings.Reserve(10);
+        assert(VectorStats::Snapshot().elements_moved == 4);
+
+        struct ThrowingMove {
+            ThrowingMove() = default;
+            ThrowingMove(const ThrowingMove&) = default;
+            ThrowingMove(ThrowingMove&& /*other*/) {
+            }
+        };
+        Vector<ThrowingMove> throwing(3);
+        VectorStats::Reset();
+        throwing.Reserve(10);
+        assert(VectorStats::Snapshot().elements_copied == 3);
+        assert(VectorStats::Snapshot().wasted_capacity_bytes == 0);
+    }
+    {
+        // Обработчик получает каждую реаллокацию, кроме первого выделения памяти
+        struct Log {
+            Vector<size_t> capacities;
+        } log;
+        log.capacities.Reserve(16);
+        VectorStats::SetReallocationCallback(
+            [](const VectorReallocationEvent& event, void* context) noexcept {
+                static_cast<Log*>(context)->capacities.PushBack(event.new_capacity);
+            },
+            &log);
+        Vector<char> v;
+        v.Resize(3);
+        v.Reserve(100);
+        v.ShrinkToFit();
+        VectorStats::SetReallocationCallback(nullptr);
+        v.Reserve(200);
+        assert(log.capacities.Size() == 2);
+        assert(log.capacities[0] == 100 && log.capacities[1] == 3);
+    }
+}
+
+struct CopyError {};
+
+struct ThrowOnCopy {
+    ThrowOnCopy() = default;
+    ThrowOnCopy(const ThrowOnCopy& other)
+        : throw_on_copy(other.throw_on_copy) {
+        if (throw_on_copy) {
+            throw CopyError{};
+        }
+    }
+    ThrowOnCopy(ThrowOnCopy&& other)
+        : throw_on_copy(other.throw_on_copy) {
+    }
+    ThrowOnCopy& operator=(const ThrowOnCopy&) = default;
+    ThrowOnCopy& operator=(ThrowOnCopy&&) = default;
+    bool throw_on_copy = false;
+};
+
+int handler_calls = 0;
+
+void CountingHandler(VectorError /*error*/, const char* /*message*/) {
+    ++handler_calls;
+}
+
+void TestErrorHandling() {
+    {
+        // Исключение копирования при реаллокации распространяется без обёртки
+        Vector<ThrowOnCopy> v(4);
+        v[2].throw_on_copy = true;
+        try {
+            v.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4);
+        try {
+            v.Emplace(v.begin() + 1);
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4);
+    }
+    {
+        // Обработчик вызывается перед стандартным исключением
+        const VectorErrorHandler previous = SetVectorErrorHandler(CountingHandler);
+        Vector<int> v(3);
+        try {
+            v.At(3);
+            assert(false && "Exception is expected");
+        } catch (const std::out_of_range&) {
+        }
+        try {
+            v.Reserve(std::numeric_limits<size_t>::max());
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        assert(handler_calls == 2 && v.Capacity() == 3);
+        assert(SetVectorErrorHandler(previous) == CountingHandler);
+    }
+}
+
+void TestCopyAssignment() {
+    {
+        // Тривиальные типы копируются одним memcpy в существующий буфер
+        Vector<int> source(3);
+        source.Iota(1);
+        Vector<int> target(10);
+        const int* buffer = target.begin();
+        target = source;
+        assert(target.Size() == 3 && target.Capacity() == 10 && target.begin() == buffer);
+        assert(target == source);
+    }
+    {
+        // Уменьшение, тот же размер и рост в пределах вместимости не выделяют память
+        Vector<std::string> target;
+        target.Reserve(8);
+        for (int i = 0; i < 6; ++i) {
+            target.PushBack(std::string(32, static_cast<char>('a' + i)));
+        }
+        const std::string* buffer = target.begin();
+        Vector<std::string> small;
+        small.PushBack("x");
+        small.PushBack("y");
+        target = small;
+        assert(target.Size() == 2 && target.begin() == buffer && target == small);
+        Vector<std::string> same = small;
+        same[1] = "z";
+        target = same;
+        assert(target.Size() == 2 && target.begin() == buffer && target[1] == "z");
+        Vector<std::string> large(7);
+        large[6] = "tail";
+        target = large;
+        assert(target.Size() == 7 && target.Capacity() == 8 && target.begin() == buffer);
+        assert(target == large);
+    }
+    {
+        // Нехватка вместимости решается политикой роста, а не точным размером источника
+        Vector<std::string> target(4);
+        const Vector<std::string> source(5);
+        target = source;
+        assert(target.Size() == 5 && target.Capacity() == 8);
+    }
+    {
+        // При исключении во время роста получатель не меняется
+        Vector<ThrowOnCopy> source(6);
+        source[4].throw_on_copy = true;
+        Vector<ThrowOnCopy> target(2);
+        const ThrowOnCopy* buffer = target.begin();
+        try {
+            target = source;
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(target.Size() == 2 && target.Capacity() == 2 && target.begin() == buffer);
+    }
+}
+
+void TestGrowBy() {
+    {
+        // Элементы конструируются в зарезервированных слотах и добавляются одним Commit
+        Vector<std::string> v;
+        v.PushBack("head");
+        {
+            auto guard = v.GrowBy(5);
+            assert(guard.Slots().Size() == 5 && guard.Slots().Data() == v.end());
+            assert(v.Size() == 1 && v.Capacity() >= 6);
+            for (int i = 0; i < 5; ++i) {
+                guard.Emplace(std::to_string(i));
+            }
+            assert(guard.Constructed() == 5 && v.Size() == 1);
+            guard.Commit();
+        }
+        assert(v.Size() == 6 && v[0] == "head" && v[5] == "4");
+    }
+    {
+        // Без Commit сконструированные элементы разрушаются, вектор не меняется
+        Vector<std::string> v(2);
+        const size_t capacity = v.Capacity();
+        {
+            auto guard = v.GrowBy(1);
+            guard.Emplace("dropped");
+        }
+        assert(v.Size() == 2 && v.Capacity() >= capacity);
+    }
+    {
+        // Исключение на середине откатывает уже сконструированные элементы
+        Vector<ThrowOnCopy> source(4);
+        source[2].throw_on_copy = true;
+        Vector<ThrowOnCopy> v(1);
+        try {
+            auto guard = v.GrowBy(source.Size());
+            for (const ThrowOnCopy& value : source) {
+                guard.Emplace(value);
+            }
+            guard.Commit();
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(v.Size() == 1);
+    }
+    {
+        // Частичный Commit: несконструированные слоты остаются свободной вместимостью
+        Vector<int> v;
+        auto guard = v.GrowBy(4);
+        guard.Emplace(1);
+        guard.Emplace(2);
+        guard.Commit();
+        assert(v.Size() == 2 && guard.Slots().Size() == 2 && guard.Slots().Data() == v.end());
+        guard.Emplace(3);
+        guard.Commit();
+        assert(v.Size() == 3 && v[2] == 3);
+    }
+    {
+        // Рост выполняется политикой роста одной реаллокацией
+        Vector<int> v(4);
+        const Span<int> tail = v.AppendUninitialized(3);
+        assert(v.Size() == 7 && v.Capacity() == 8 && tail.Data() == v.begin() + 4 && tail.Size() == 3);
+        for (size_t i = 0; i < tail.Size(); ++i) {
+            tail[i] = static_cast<int>(i) + 10;
+        }
+        assert(v[4] == 10 && v[6] == 12);
+        assert(v.AppendUninitialized(0).Empty() && v.Size() == 7);
+    }
+    {
+        // Быстрый путь EmplaceBack и реаллокация с аргументом-ссылкой на элемент вектора
+        Vector<std::string> v;
+        v.Reserve(2);
+        v.EmplaceBack(3, 'a');
+        v.EmplaceBack(v[0]);
+        assert(v.Size() == 2 && v.Capacity() == 2);
+        v.EmplaceBack(v[1]);
+        assert(v.Size() == 3 && v.Capacity() == 4 && v[2] == "aaa");
+    }
+}
+
+void TestFlatMap() {
+    {
+        // Поиск без ветвлений совпадает с std::lower_bound на всех позициях
+        const int keys[] = {1, 3, 3, 5, 8, 13, 21};
+        for (size_t size = 0; size <= std::size(keys); ++size) {
+            for (int key = 0; key <= 22; ++key) {
+                const size_t expected = static_cast<size_t>(std::lower_bound(keys, keys + size, key) - keys);
+                assert(vector_detail::LowerBoundIndex(keys, size, key, std::less<int>()) == expected);
+            }
+        }
+    }
+    {
+        FlatSet<int> set = {5, 1, 4, 1, 3};
+        assert(set.Size() == 4 && *set.begin() == 1 && set.Keys()[3] == 5);
+        assert(set.Contains(4) && !set.Contains(2) && set.Find(2) == set.end());
+        assert(set.Insert(2).second && !set.Insert(2).second && set.Size() == 5);
+        assert(*set.LowerBound(3) == 3 && *set.UpperBound(3) == 4 && set.UpperBound(5) == set.end());
+        assert(set.Erase(3) == 1 && set.Erase(3) == 0 && set.Count(3) == 0);
+
+        // Слияние: повторы внутри диапазона и уже имеющиеся ключи отбрасываются
+        const int sorted[] = {0, 2, 2, 6, 7};
+        set.InsertSorted(std::begin(sorted), std::end(sorted));
+        assert((set == FlatSet<int>{0, 1, 2, 4, 5, 6, 7}));
+        set.Reserve(64);
+        assert(set.Capacity() == 64);
+        set.ShrinkToFit();
+        assert(set.Capacity() == set.Size());
+    }
+    {
+        FlatSet<int, std::greater<int>> descending = {1, 3, 2};
+        assert(descending.Keys()[0] == 3 && descending.Keys()[2] == 1 && descending.Contains(2));
+    }
+    {
+        FlatMap<std::string, int> map = {{"b", 2}, {"a", 1}, {"b", 20}};
+        assert(map.Size() == 2 && map.KeyAt(0) == "a" && map.At("b") == 2);
+        map["c"] = 3;
+        ++map["a"];
+        assert(map.Size() == 3 && map.ValueAt(0) == 2 && *map.Find("c") == 3 && map.Find("d") == nullptr);
+        assert(!map.TryEmplace("c", 30).second && map.At("c") == 3);
+        assert(!map.InsertOrAssign("c", 30).second && map.At("c") == 30);
+        assert(map.Insert("0", 0).second && map.KeyAt(0) == "0");
+        try {
+            map.At("missing");
+            assert(false && "Exception is expected");
+        } catch (const std::out_of_range&) {
+        }
+
+        const std::pair<std::string, int> batch[] = {{"a", 100}, {"aa", 11}, {"d", 4}, {"d", 40}};
+        map.InsertSorted(std::begin(batch), std::end(batch));
+        assert(map.Size() == 6 && map.At("a") == 2 && map.At("aa") == 11 && map.At("d") == 4);
+        assert(std::is_sorted(map.Keys().begin(), map.Keys().end()));
+        assert(map.Erase("aa") == 1 && map.Erase("aa") == 0 && map.Size() == 5);
+        int sum = 0;
+        for (int value : map.Values()) {
+            sum += value;
+        }
+        assert(sum == 0 + 2 + 2 + 30 + 4);
+    }
+    {
+        // При исключении копирования значения слияние не меняет словарь
+        FlatMap<int, ThrowOnCopy> map;
+        map.TryEmplace(1);
+        map.TryEmplace(3);
+        std::pair<int, ThrowOnCopy> batch[2] = {};
+        batch[0].first = 0;
+        batch[1].first = 2;
+        batch[1].second.throw_on_copy = true;
+        try {
+            map.InsertSorted(std::begin(batch), std::end(batch));
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(map.Size() == 2 && map.KeyAt(0) == 1 && map.KeyAt(1) == 3);
+    }
+}
+
+void TestTrivialElementShifts() {
+    {
+        // Вставка в середину сдвигает хвост тривиального типа побайтово; аргумент может
+        // ссылаться на сдвигаемый элемент
+        Vector<int> v = {0, 1, 2, 3, 4, 5};
+        v.Reserve(32);
+        v.Insert(v.begin() + 1, v[4]);
+        assert((v == Vector<int>{0, 4, 1, 2, 3, 4, 5}));
+        v.Insert(v.begin() + 5, size_t{1}, v[6]);
+        assert((v == Vector<int>{0, 4, 1, 2, 3, 5, 4, 5}));
+        v.Insert(v.begin() + 2, size_t{10}, -1);
+        assert(v.Size() == 18 && v[1] == 4 && v[2] == -1 && v[11] == -1 && v[12] == 1 && v[17] == 5);
+        const int extra[] = {7, 8};
+        v.Insert(v.begin() + 16, extra, extra + 2);
+        assert(v.Size() == 20 && v[16] == 7 && v[17] == 8 && v[18] == 4 && v[19] == 5);
+        v.Erase(v.begin() + 2, v.begin() + 12);
+        assert((v == Vector<int>{0, 4, 1, 2, 3, 5, 7, 8, 4, 5}));
+        assert(v.Capacity() == 32);
+    }
+    {
+        // Тривиально разрушаемые элементы: Resize, PopBack и Clear не меняют вместимость
+        Vector<double> v(10, 1.5);
+        v.Resize(3);
+        v.PopBack();
+        assert(v.Size() == 2 && v.Capacity() == 10 && v[1] == 1.5);
+        v.Clear();
+        assert(v.Empty() && v.Capacity() == 10);
+    }
+}
+
+void TestRecyclingAllocator() {
+    RecyclingCache::Trim();
+    const auto fill = [](size_t count) {
+        RecyclingVector<int> v;
+        for (size_t i = 0; i < count; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.Size() == count && v[count - 1] == static_cast<int>(count) - 1);
+    };
+    {
+        // Вместимость — весь блок класса; буферы лестницы реаллокаций остаются в кеше потока
+        RecyclingVector<int> v(1);
+        assert(v.Capacity() == RecyclingCache::MIN_BLOCK_BYTES / sizeof(int));
+        VectorStats::Reset();
+        fill(1000);
+        assert(VectorStats::Snapshot().recycle_misses == 7 && VectorStats::Snapshot().recycle_hits == 0);
+        assert(RecyclingCache::CachedBytes() == 8128);
+
+        // Повторный цикл не обращается к куче
+        fill(1000);
+        assert(VectorStats::Snapshot().recycle_misses == 7 && VectorStats::Snapshot().recycle_hits == 7);
+        assert(RecyclingCache::CachedBytes() == 8128);
+    }
+    {
+        // Большие блоки и нулевой бюджет минуют кеш
+        const size_t cached = RecyclingCache::CachedBytes();
+        RecyclingVector<char>(RecyclingCache::MAX_BLOCK_BYTES + 1);
+        assert(RecyclingCache::CachedBytes() == cached);
+        RecyclingCache::SetBudget(0);
+        assert(RecyclingCache::CachedBytes() == 0);
+        fill(100);
+        assert(RecyclingCache::CachedBytes() == 0);
+        RecyclingCache::SetBudget(RecyclingCache::DEFAULT_BUDGET_BYTES);
+        static_assert(RecyclingCache::BlockBytes(1) == 64 && RecyclingCache::BlockBytes(65) == 128);
+        static_assert(RecyclingCache::BlockBytes(RecyclingCache::MAX_BLOCK_BYTES + 1) == 0);
+    }
+    {
+        // Буфер, освобождённый другим потоком, попадает в его кеш; кеш завершившегося потока освобождается
+        RecyclingVector<int> v(100);
+        std::thread([&v] {
+            {
+                RecyclingVector<int> local(std::move(v));
+            }
+            assert(RecyclingCache::CachedBytes() == 512);
+        }).join();
+        assert(v.Empty() && RecyclingCache::CachedBytes() == 0);
+    }
+    {
+        // Подсказка быстро растёт и медленно уменьшается
+        CapacityHint hint;
+        hint.Learn(1000);
+        assert(hint.Capacity() == 1000);
+        hint.Learn(200);
+        assert(hint.Capacity() == 900);
+        hint.Learn(2000);
+        assert(hint.Capacity() == 2000);
+    }
+    {
+        // Вектор на месте вызова с подсказкой сразу получает итоговую вместимость
+        const auto handle_request = [](size_t count) {
+            RecyclingVector<int> v;
+            CapacityHintScope scope(VECTOR_CAPACITY_HINT(), v);
+            const size_t initial_capacity = v.Capacity();
+            for (size_t i = 0; i < count; ++i) {
+                v.PushBack(static_cast<int>(i));
+            }
+            return initial_capacity;
+        };
+        assert(handle_request(300) == 0);
+        VectorStats::Reset();
+        assert(handle_request(300) >= 300);
+        assert(VectorStats::Snapshot().reallocations == 0 && VectorStats::Snapshot().recycle_hits == 1);
+
+        // Другое место вызова учится отдельно
+        RecyclingVector<int> other;
+        CapacityHintScope scope(VECTOR_CAPACITY_HINT(), other);
+        assert(other.Capacity() == 0);
+    }
+    RecyclingCache::Trim();
+}
+
+void TestConcurrentVector() {
+    {
+        ConcurrentVector<std::string, std::allocator<std::string>, 4> v;
+        for (int i = 0; i < 100; ++i) {
+            assert(v.PushBack(std::to_string(i)) == static_cast<size_t>(i));
+        }
+        const std::string* first = &v[0];
+        v.EmplaceBack(3, 'x');
+        // Рост не перемещает добавленные элементы
+        assert(&v[0] == first && v.Size() == 101 && v[100] == "xxx" && v.At(99) == "99");
+        assert(v.Capacity() == 4 + 8 + 16 + 32 + 64);
+
+        // Пакет пересекает границу сегментов и становится видимым после Commit
+        auto batch = v.GrowBy(100);
+        assert(batch.FirstIndex() == 101 && v.Size() == 101);
+        size_t spans = 0;
+        size_t next = 0;
+        batch.ForEachSpan([&](Span<std::string> span) {
+            ++spans;
+            for (std::string& s : span) {
+                s = std::to_string(next++);
+            }
+        });
+        assert(spans == 2 && next == 100);
+        batch.Commit();
+        assert(v.Size() == 201 && v[101] == "0" && v[200] == "99");
+
+        // Незаконченный пакет не задерживает последующие добавления: префикс продвинет Commit
+        auto pending = v.GrowBy(3);
+        assert(v.PushBack("after") == 204 && v.Size() == 201);
+        pending[2] = "pending";
+        pending.Commit();
+        assert(v.Size() == 205 && v[203] == "pending" && v[204] == "after");
+    }
+    {
+        const size_t THREADS = 8;
+        const size_t PER_THREAD = 20000;
+        const size_t BATCH = 100;
+        ConcurrentVector<size_t> v;
+        std::atomic<bool> stop{false};
+
+        // Читатель проверяет опубликованный префикс параллельно с добавлением
+        std::thread reader([&] {
+            while (!stop.load()) {
+                const size_t size = v.Size();
+                for (size_t i = 0; i < size; i += 97) {
+                    assert(v[i] < THREADS * PER_THREAD * 2);
+                }
+            }
+        });
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < THREADS; ++t) {
+            writers.emplace_back([&v, t] {
+                const size_t base = t * PER_THREAD;
+                for (size_t i = 0; i < PER_THREAD / 2; ++i) {
+                    v.PushBack(base + i);
+                }
+                for (size_t i = PER_THREAD / 2; i < PER_THREAD; i += BATCH) {
+                    auto batch = v.GrowBy(BATCH);
+                    size_t value = base + i;
+                    batch.ForEachSpan([&value](Span<size_t> span) {
+                        for (size_t& x : span) {
+                            x = value++;
+                        }
+                    });
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        stop = true;
+        reader.join();
+
+        assert(v.Size() == THREADS * PER_THREAD);
+        std::vector<size_t> values;
+        v.ForEachSpan([&values](Span<size_t> span) {
+            values.insert(values.end(), span.begin(), span.end());
+        });
+        std::sort(values.begin(), values.end());
+        for (size_t i = 0; i < values.size(); ++i) {
+            assert(values[i] == i);
+        }
+    }
+}
+
+struct ParallelTracked {
+    ParallelTracked() {
+        if (++constructed == throw_at) {
+            throw std::runtime_error("construction failed");
+        }
+        ++alive;
+    }
+    ParallelTracked(const ParallelTracked& other)
+        : value(other.value) {
+        if (++constructed == throw_at) {
+            throw std::runtime_error("copy failed");
+        }
+        ++alive;
+    }
+    ParallelTracked& operator=(const ParallelTracked&) = default;
+    ~ParallelTracked() {
+        --alive;
+    }
+
+    static void Reset(int throw_at_value) {
+        constructed = 0;
+        alive = 0;
+        throw_at = throw_at_value;
+    }
+
+    int value = 1;
+    static inline std::atomic<int> constructed{0};
+    static inline std::atomic<int> alive{0};
+    static inline int throw_at = 0;
+};
+
+void TestParallelOperations() {
+    // Маленький min_chunk_bytes, чтобы в тесте работали несколько потоков
+    const ParallelTag tag(4, 1);
+    {
+        Vector<std::string> v(1000, tag);
+        assert(v.Size() == 1000 && v[999].empty());
+        for (size_t i = 0; i < v.Size(); ++i) {
+            v[i] = std::to_string(i);
+        }
+        Vector<std::string> copy(v, tag);
+        assert(copy.Size() == 1000 && copy[0] == "0" && copy[999] == "999");
+
+        Vector<std::string> target(10);
+        target.ParallelCopyFrom(v, tag);
+        assert(target.Size() == 1000 && target[500] == "500");
+        v.Resize(300);
+        target.ParallelCopyFrom(v, tag);
+        assert(target.Size() == 300 && target[299] == "299" && target.Capacity() == 1000);
+        target.ParallelClear(tag);
+        assert(target.Empty() && target.Capacity() == 1000);
+    }
+    {
+        // Исключение в одной части разрушает уже сконструированные элементы всех частей
+        ParallelTracked::Reset(700);
+        try {
+            Vector<ParallelTracked> v(1000, tag);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(ParallelTracked::alive == 0);
+
+        ParallelTracked::Reset(0);
+        Vector<ParallelTracked> source(1000, tag);
+        Vector<ParallelTracked> target(10);
+        ParallelTracked::throw_at = ParallelTracked::constructed + 500;
+        try {
+            target.ParallelCopyFrom(source, tag);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        // Строгая гарантия при реаллокации
+        assert(target.Size() == 10 && target.Capacity() == 10);
+        assert(ParallelTracked::alive == 1010);
+    }
+}
+
+void TestStableVector() {
+    {
+        StableVector<std::string, std::allocator<std::string>, 4> v;
+        v.PushBack("first");
+        const std::string* first = &v[0];
+        for (int i = 1; i < 1000; ++i) {
+            // Аргумент ссылается на элемент вектора: при росте он не переезжает
+            v.EmplaceBack(v.back());
+        }
+        assert(&v[0] == first && v.Size() == 1000 && v[999] == "first");
+        assert(v.Capacity() == 4 * (256 - 1));
+
+        for (int i = 0; i < 1000; ++i) {
+            v[i] = std::to_string(i);
+        }
+        // Итераторы произвольного доступа проходят по сегментам
+        assert(std::distance(v.begin(), v.end()) == 1000);
+        assert(*(v.begin() + 500) == "500" && v.end()[-1] == "999");
+        size_t index = 0;
+        for (const std::string& s : v) {
+            assert(s == std::to_string(index++));
+        }
+        StableVector<std::string, std::allocator<std::string>, 4>::const_iterator it = v.begin();
+        it += 3;
+        assert(*it == "3" && *--it == "2" && it - v.cbegin() == 2);
+
+        size_t spans = 0;
+        size_t total = 0;
+        v.ForEachSpan([&](Span<std::string> span) {
+            ++spans;
+            total += span.Size();
+        });
+        assert(spans == 8 && total == 1000);
+
+        StableVector<std::string, std::allocator<std::string>, 4> copy(v);
+        assert(copy.Size() == 1000 && copy[123] == "123" && &copy[0] != &v[0]);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Size() == 10 && v.Capacity() == 12 && v.At(9) == "9" && &v[0] == first);
+        copy = v;
+        assert(copy.Size() == 10 && copy.back() == "9");
+        v = std::move(copy);
+        assert(v.Size() == 10 && copy.Empty());
+    }
+    {
+        // Исключение при копировании не оставляет живых элементов
+        Obj::ResetCounters();
+        {
+            StableVector<Obj> v(100);
+            v[60].throw_on_copy = true;
+            try {
+                StableVector<Obj> copy(v);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(Obj::GetAliveObjectCount() == 100);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        StableVector<int> v{1, 2, 3};
+        std::sort(v.begin(), v.end(), std::greater<int>());
+        assert(v[0] == 3 && v[2] == 1);
+    }
+    {
+        // Присваивание pmr-векторов сохраняет ресурс получателя
+        using PmrStable = StableVector<std::string, std::pmr::polymorphic_allocator<std::string>, 4>;
+        ArenaResource arena1;
+        ArenaResource arena2;
+        PmrStable a(&arena1);
+        for (int i = 0; i < 20; ++i) {
+            a.PushBack(std::to_string(i));
+        }
+        PmrStable b(&arena2);
+        b.PushBack("old");
+        const size_t used = arena2.BytesAllocated();
+        b = a;
+        assert(b.Size() == 20 && b[19] == "19" && a.Size() == 20);
+        assert(b.GetAllocator().resource() == &arena2 && arena2.BytesAllocated() > used);
+
+        PmrStable c(&arena2);
+        c = std::move(a);
+        assert(c.Size() == 20 && c[7] == "7" && a.Empty());
+        assert(c.GetAllocator().resource() == &arena2);
+
+        PmrStable d(&arena2);
+        d = std::move(c);
+        assert(d.Size() == 20 && d[0] == "0" && c.Empty());
+        d.Swap(b);
+        assert(b.Size() == 20 && d.Size() == 20);
+    }
+}
+
+void TestSharedVector() {
+    {
+        SharedVector<std::string> a{"x", "y", "z"};
+        SharedVector<std::string> b = a;
+        assert(a.UseCount() == 2 && a.Data() == b.Data());
+
+        // Изменение отделяет только изменяемую копию
+        b.Mutable(0) = "changed";
+        assert(a.UseCount() == 1 && b.UseCount() == 1 && a.Data() != b.Data());
+        assert(a[0] == "x" && b[0] == "changed" && b[2] == "z");
+
+        // Единственный владелец меняет блок на месте
+        const std::string* data = b.Data();
+        b.Mutable(1) = "mutated";
+        assert(b.Data() == data && b[1] == "mutated");
+    }
+    {
+        // Снимок не видит последующих добавлений, а писатель добавляет без копирования
+        SharedVector<int> writer;
+        writer.Reserve(100);
+        for (int i = 0; i < 10; ++i) {
+            writer.PushBack(i);
+        }
+        const int* data = writer.Data();
+        SharedVector<int> snapshot = writer.Snapshot();
+        for (int i = 10; i < 50; ++i) {
+            writer.PushBack(i);
+        }
+        assert(writer.Data() == data && writer.UseCount() == 2);
+        assert(snapshot.Size() == 10 && snapshot.back() == 9 && writer.Size() == 50);
+
+        // Снимок, который добавляет сам, не может занять чужой слот и отделяется
+        snapshot.PushBack(-1);
+        assert(snapshot.Data() != data && snapshot.Size() == 11 && snapshot.back() == -1);
+        assert(writer[10] == 10 && writer.UseCount() == 1);
+
+        // Рост за пределы вместимости переносит писателя в новый блок, старый живёт у читателей
+        SharedVector<int> reader = writer.Snapshot();
+        for (int i = 50; i < 200; ++i) {
+            writer.PushBack(i);
+        }
+        assert(reader.Data() == data && reader.Size() == 50 && reader[49] == 49);
+        assert(writer.Size() == 200 && writer[199] == 199);
+    }
+    {
+        // PopBack у разделённого блока только укорачивает префикс
+        SharedVector<std::string> a{"1", "2", "3"};
+        SharedVector<std::string> b = a;
+        b.PopBack();
+        assert(b.Size() == 2 && a.Size() == 3 && a[2] == "3");
+        b.PushBack("4");
+        assert(b[2] == "4" && a[2] == "3");
+
+        // После ухода владельца с более длинным префиксом лишние элементы разрушаются
+        a = SharedVector<std::string>();
+        SharedVector<std::string> c{"a"};
+        c.PushBack("b");
+        SharedVector<std::string> d = c;
+        d.PushBack("c");
+        d = SharedVector<std::string>();
+        c.PopBack();
+        c.Clear();
+        assert(c.Empty());
+    }
+    {
+        // Буфер Vector забирается без копирования
+        Vector<int> source{1, 2, 3};
+        const int* data = source.begin();
+        SharedVector<int> shared(std::move(source));
+        assert(source.Capacity() == 0 && shared.Data() == data && shared.Size() == 3);
+        assert(shared.ToVector() == Vector<int>({1, 2, 3}));
+
+        Vector<int> copy_source{4, 5};
+        SharedVector<int> copied(copy_source);
+        assert(copied.Data() != copy_source.begin() && copied[1] == 5);
+    }
+    {
+        // Исключение при отделении оставляет вектор прежним
+        ThrowOnCopy value;
+        value.throw_on_copy = true;
+        SharedVector<ThrowOnCopy> a;
+        a.PushBack(std::move(value));
+        SharedVector<ThrowOnCopy> b = a;
+        try {
+            b.Mutable(0);
+            assert(false);
+        } catch (const CopyError&) {
+        }
+        assert(a.UseCount() == 2 && b.Data() == a.Data());
+    }
+    {
+        // Читатели получают снимки, пока писатель добавляет элементы
+        SharedVector<size_t> writer;
+        std::mutex mutex;
+        SharedVector<size_t> published;
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            while (!done.load()) {
+                SharedVector<size_t> view;
+                {
+                    std::lock_guard lock(mutex);
+                    view = published;
+                }
+                for (size_t i = 0; i < view.Size(); ++i) {
+                    assert(view[i] == i);
+                }
+            }
+        });
+        for (size_t i = 0; i < 20000; ++i) {
+            writer.PushBack(i);
+            if (i % 100 == 0) {
+                std::lock_guard lock(mutex);
+                published = writer.Snapshot();
+            }
+        }
+        done = true;
+        reader.join();
+        assert(writer.Size() == 20000);
+    }
+    {
+        // pmr-аллокатор не распространяется при присваивании: получатель разделяет блок
+        // источника, сохраняя свой ресурс, а блок освобождается ресурсом, которым выделен
+        using PmrShared = SharedVector<int, std::pmr::polymorphic_allocator<int>>;
+        std::pmr::unsynchronized_pool_resource pool1;
+        std::pmr::unsynchronized_pool_resource pool2;
+        PmrShared y(&pool2);
+        {
+            PmrShared x({1, 2, 3}, &pool1);
+            y = x;
+            assert(y.Size() == 3 && y.Data() == x.Data() && y.UseCount() == 2);
+            assert(y.GetAllocator().resource() == &pool2);
+            y.PushBack(4);
+            assert(y.Data() != x.Data() && x.Size() == 3);
+            y = x;
+            assert(y.Data() == x.Data() && y.GetAllocator().resource() == &pool2);
+        }
+        // Последний владелец блока из pool1 — y
+        assert(y.UseCount() == 1 && y[2] == 3);
+        y.PushBack(4);
+        assert(y.Size() == 4 && y[3] == 4);
+
+        PmrShared z(&pool1);
+        z = std::move(y);
+        assert(z.Size() == 4 && y.Empty() && z.GetAllocator().resource() == &pool1);
+        y = z;
+        y.Clear();
+        assert(z.UseCount() == 1);
+    }
+}
+
+void TestSoAVector() {
+    {
+        SoAVector<int, double, std::string> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i, i * 0.5, std::to_string(i));
+        }
+        assert(v.Size() == 100 && v.Capacity() == 128);
+
+        // Строковый доступ через прокси
+        auto [id, weight, name] = v[10];
+        assert(id == 10 && weight == 5.0 && name == "10");
+        name = "ten";
+        assert(std::get<2>(v[10]) == "ten");
+        v[11] = std::make_tuple(-1, 0.0, std::string("minus"));
+        assert(std::get<0>(v.At(11)) == -1);
+
+        // Проход по одному столбцу
+        long long sum = 0;
+        for (int x : v.Column<0>()) {
+            sum += x;
+        }
+        assert(sum == 99 * 100 / 2 - 11 - 1);
+        assert(v.Column<1>().Size() == 100 && v.Column<1>()[99] == 49.5);
+
+        // Аргумент ссылается на элемент контейнера во время реаллокации
+        v.Resize(128);
+        v.EmplaceBack(std::get<0>(v[0]), std::get<1>(v[1]), std::get<2>(v[2]));
+        assert(v.Size() == 129 && std::get<2>(v[128]) == "2" && std::get<0>(v[128]) == 0);
+
+        const SoAVector<int, double, std::string> copy(v);
+        assert(copy.Size() == 129 && std::get<2>(copy[10]) == "ten");
+        v.PopBack();
+        v.PushBack(std::make_tuple(7, 7.0, std::string("seven")));
+        assert(std::get<2>(v[128]) == "seven");
+    }
+    {
+        // Исключение при копировании одного столбца оставляет все столбцы нетронутыми
+        SoAVector<std::string, ThrowOnCopy, int> v;
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(std::to_string(i), ThrowOnCopy(), i);
+        }
+        std::get<1>(v[2]).throw_on_copy = true;
+        try {
+            v.Reserve(100);
+            assert(false && "Exception is expected");
+        } catch (const CopyError&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4);
+        assert(std::get<0>(v[3]) == "3" && std::get<2>(v[3]) == 3);
+    }
+    {
+        // Исключение в конструкторе копирования и в конструкторе размера не оставляет живых строк
+        Obj::ResetCounters();
+        {
+            SoAVector<int, Obj> v;
+            for (int i = 0; i < 5; ++i) {
+                v.EmplaceBack(i, Obj(i));
+            }
+            std::get<1>(v[3]).throw_on_copy = true;
+            try {
+                SoAVector<int, Obj> copy(v);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(Obj::GetAliveObjectCount() == 5);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        Obj::default_construction_throw_countdown = 4;
+        try {
+            SoAVector<int, Obj> v(5);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -750,6 +2946,32 @@ int main() {
     TestClear();
     TestAt();
     TestFrontBack();        
+    TestAllocators();
+    TestRelocation();
+    TestSmallVector();
+    TestGrowthPolicies();
+    TestAlignedAllocation();
+    TestMallocAllocator();
+    TestVectorAlgorithms();
+    TestAdoptRelease();
+    TestMappedVector();
+    TestVectorIo();
+    TestSharedVector();
+    TestRangeInsertion();
+    TestRangeErase();
+    TestDefaultInit();
+    TestShrinkToFit();
+    TestStats();
+    TestErrorHandling();
+    TestCopyAssignment();
+    TestGrowBy();
+    TestFlatMap();
+    TestTrivialElementShifts();
+    TestRecyclingAllocator();
+    TestConcurrentVector();
+    TestParallelOperations();
+    TestStableVector();
+    TestSoAVector();
 
     std::cout << "All tests passed!\n";
 }
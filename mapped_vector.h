@@ -0,0 +1,394 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Режим отображения файла
+enum class MappedMode {
+    READ_ONLY,   // только чтение; страницы разделяются со всеми процессами, читающими файл
+    READ_WRITE,  // MAP_SHARED: изменения попадают в файл; отсутствующий файл создаётся
+};
+
+// Подсказка ядру о порядке доступа к отображённым страницам (posix_madvise)
+enum class AccessHint {
+    NORMAL,
+    SEQUENTIAL,  // агрессивное упреждающее чтение, прочитанные страницы можно вытеснять раньше
+    RANDOM,      // упреждающее чтение бесполезно
+    WILL_NEED,   // начать чтение страниц заранее
+    DONT_NEED,   // страницы пока не нужны
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Вектор тривиально копируемых элементов, хранящихся в файле, отображённом в память (mmap).
+// Файл — обычный массив записей T без заголовка, поэтому подходят уже существующие файлы данных:
+// размер вектора равен размеру файла, делённому на sizeof(T). Открытие не читает данные и занимает
+// O(1), страницы подгружаются при первом обращении и разделяются между процессами через кеш страниц.
+// Рост (Reserve, PushBack) удлиняет файл через ftruncate и переотображает его (mremap на Linux),
+// поэтому, как и в Vector, рост делает недействительными указатели на элементы. Запас вместимости
+// хранится в файле как хвост из нулевых записей и отрезается в Close; после аварийного
+// завершения он остаётся в файле. Ошибки системных вызовов передаются ReportVectorError
+// с VectorError::SYSTEM_ERROR. Методы изменения допустимы только в режиме READ_WRITE
+template <typename T>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires a trivially copyable type");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Итераторы
+    iterator begin() noexcept {
+        return data_;
+    }
+
+    iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Конструкторы
+    MappedVector() = default;
+
+    // Отображает файл path. В режиме READ_WRITE отсутствующий файл создаётся пустым
+    explicit MappedVector(const char* path, MappedMode mode = MappedMode::READ_ONLY)
+        : mode_(mode) {
+        const bool writable = mode == MappedMode::READ_WRITE;
+        fd_ = writable ? open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644) : open(path, O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            Fail("MappedVector: cannot open file");
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            Fail("MappedVector: fstat failed");
+        }
+        const size_t bytes = static_cast<size_t>(st.st_size);
+        if (bytes % sizeof(T) != 0) {
+            errno = EINVAL;
+            Fail("MappedVector: file size is not a multiple of the element size");
+        }
+        size_ = bytes / sizeof(T);
+        if (size_ != 0) {
+            data_ = Map(size_);
+            if (data_ == nullptr) {
+                Fail("MappedVector: mmap failed");
+            }
+            capacity_ = size_;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0))
+        , fd_(std::exchange(other.fd_, -1))
+        , mode_(other.mode_) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            MappedVector(std::move(rhs)).Swap(*this);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Close();
+    }
+
+    void Swap(MappedVector& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(fd_, other.fd_);
+        std::swap(mode_, other.mode_);
+    }
+
+    // Снимает отображение, отрезает запас вместимости в конце файла и закрывает файл.
+    // Данные не сбрасываются на диск принудительно: для этого служит Flush
+    void Close() noexcept {
+        if (data_ != nullptr) {
+            munmap(data_, capacity_ * sizeof(T));
+        }
+        if (fd_ >= 0) {
+            if (IsWritable() && capacity_ != size_) {
+                [[maybe_unused]] const int result = ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+            }
+            close(fd_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        fd_ = -1;
+    }
+
+    // Методы доступа
+    bool IsOpen() const noexcept {
+        return fd_ >= 0;
+    }
+
+    bool IsWritable() const noexcept {
+        return IsOpen() && mode_ == MappedMode::READ_WRITE;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    T* Data() noexcept {
+        return data_;
+    }
+
+    const T* Data() const noexcept {
+        return data_;
+    }
+
+    // В режиме READ_ONLY запись через возвращённую ссылку приводит к SIGSEGV
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+
+    T& At(size_t index) {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "MappedVector::At: index out of range");
+        }
+        return data_[index];
+    }
+
+    const T& At(size_t index) const {
+        return const_cast<MappedVector&>(*this).At(index);
+    }
+
+    T& front() {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return data_[0];
+    }
+
+    const T& front() const {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return data_[0];
+    }
+
+    T& back() {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return data_[size_ - 1];
+    }
+
+    const T& back() const {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return data_[size_ - 1];
+    }
+
+    // Алгоритмы над элементами, как у Vector (см. simd_kernels.h)
+    const_iterator Find(const T& value) const {
+        return vector_simd::Find(cbegin(), cend(), value);
+    }
+
+    size_t Count(const T& value) const {
+        return vector_simd::Count(cbegin(), cend(), value);
+    }
+
+    bool Contains(const T& value) const {
+        return Find(value) != cend();
+    }
+
+    T Sum() const {
+        return vector_simd::Sum(cbegin(), cend());
+    }
+
+    std::pair<T, T> MinMax() const {
+        assert(size_ > 0 && "Cannot call MinMax() on empty vector");
+        return vector_simd::MinMax(cbegin(), cend());
+    }
+
+    // Удлиняет файл и переотображает его не меньше чем под capacity элементов. При ошибке
+    // вектор остаётся прежним
+    void Reserve(size_t capacity) {
+        AssertWritable();
+        if (capacity <= capacity_) {
+            return;
+        }
+        if (capacity > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::LENGTH_ERROR, "MappedVector: capacity exceeds max_size");
+        }
+        if (ftruncate(fd_, static_cast<off_t>(capacity * sizeof(T))) != 0) {
+            ReportVectorError(VectorError::SYSTEM_ERROR, "MappedVector: ftruncate failed");
+        }
+        T* data = Remap(capacity);
+        if (data == nullptr) {
+            // Файл возвращается к прежней длине, иначе хвост из нулей остался бы в нём записями
+            const int error = errno;
+            [[maybe_unused]] const int result = ftruncate(fd_, static_cast<off_t>(capacity_ * sizeof(T)));
+            errno = error;
+            ReportVectorError(VectorError::SYSTEM_ERROR, "MappedVector: mmap failed");
+        }
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    // Новые элементы инициализируются значением (нулями, как и удлинённый файл)
+    void Resize(size_t new_size) {
+        AssertWritable();
+        if (new_size > capacity_) {
+            Reserve(new_size);
+        }
+        if (new_size > size_) {
+            std::uninitialized_value_construct_n(end(), new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        AssertWritable();
+        size_ = 0;
+    }
+
+    // Методы размещения и удаления. Аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        AssertWritable();
+        if (size_ == capacity_) {
+            // Элемент создаётся до переотображения, которое может сдвинуть аргументы-ссылки
+            T value(std::forward<Args>(args)...);
+            Reserve(growth_.NextCapacity(capacity_, std::max(size_ + 1, MinCapacity()), sizeof(T)));
+            new (end()) T(value);
+        } else {
+            new (end()) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() noexcept {
+        AssertWritable();
+        assert(size_ > 0 && "PopBack() called on empty vector");
+        --size_;
+    }
+
+    // Записывает изменённые страницы в файл (msync). С async == true только ставит запись в очередь
+    void Flush(bool async = false) {
+        AssertWritable();
+        if (data_ != nullptr && msync(data_, size_ * sizeof(T), async ? MS_ASYNC : MS_SYNC) != 0) {
+            ReportVectorError(VectorError::SYSTEM_ERROR, "MappedVector: msync failed");
+        }
+    }
+
+    // Подсказывает ядру порядок доступа ко всему отображению. Подсказка необязательна,
+    // поэтому отказ системы игнорируется
+    void Advise(AccessHint hint) noexcept {
+        if (data_ == nullptr) {
+            return;
+        }
+        int advice = POSIX_MADV_NORMAL;
+        switch (hint) {
+            case AccessHint::NORMAL:
+                break;
+            case AccessHint::SEQUENTIAL:
+                advice = POSIX_MADV_SEQUENTIAL;
+                break;
+            case AccessHint::RANDOM:
+                advice = POSIX_MADV_RANDOM;
+                break;
+            case AccessHint::WILL_NEED:
+                advice = POSIX_MADV_WILLNEED;
+                break;
+            case AccessHint::DONT_NEED:
+                advice = POSIX_MADV_DONTNEED;
+                break;
+        }
+        posix_madvise(data_, capacity_ * sizeof(T), advice);
+    }
+
+private:
+    // Первое выделение удлиняет файл хотя бы на страницу
+    static size_t MinCapacity() noexcept {
+        return std::max<size_t>(static_cast<size_t>(sysconf(_SC_PAGESIZE)) / sizeof(T), 1);
+    }
+
+    void AssertWritable() const noexcept {
+        assert(IsWritable() && "Modification of a read-only MappedVector");
+    }
+
+    T* Map(size_t capacity) noexcept {
+        const int protection = mode_ == MappedMode::READ_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* p = mmap(nullptr, capacity * sizeof(T), protection, MAP_SHARED, fd_, 0);
+        return p == MAP_FAILED ? nullptr : static_cast<T*>(p);
+    }
+
+    // Отображение файла под новую вместимость. Старое отображение сохраняется при ошибке
+    T* Remap(size_t capacity) noexcept {
+        if (data_ == nullptr) {
+            return Map(capacity);
+        }
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        void* p = mremap(data_, capacity_ * sizeof(T), capacity * sizeof(T), MREMAP_MAYMOVE);
+        return p == MAP_FAILED ? nullptr : static_cast<T*>(p);
+#else
+        T* data = Map(capacity);
+        if (data != nullptr) {
+            munmap(data_, capacity_ * sizeof(T));
+        }
+        return data;
+#endif
+    }
+
+    // Освобождает ресурсы частично открытого вектора и сообщает об ошибке с исходным errno
+    [[noreturn]] void Fail(const char* message) {
+        const int error = errno;
+        Close();
+        errno = error;
+        ReportVectorError(VectorError::SYSTEM_ERROR, message);
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    int fd_ = -1;
+    MappedMode mode_ = MappedMode::READ_ONLY;
+    [[no_unique_address]] DoublingGrowth growth_;
+};
+
+#endif
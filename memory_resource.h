@@ -0,0 +1,233 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Монотонная арена: выделение сводится к сдвигу указателя внутри текущего блока,
+// освобождение отдельных участков ничего не делает, а Release() возвращает всю память
+// одним вызовом за O(число блоков). Подходит для векторов, живущих в пределах одного запроса.
+// Первый блок может быть внешним буфером (например, на стеке) — тогда в простых случаях
+// глобальная куча не используется вовсе. Класс не потокобезопасен.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(size_t initial_block_size = 4096,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+        , next_block_size_(std::max(initial_block_size, MIN_BLOCK_SIZE)) {
+    }
+
+    // Арена, первым блоком которой служит внешний буфер. Буфер не освобождается ареной
+    ArenaResource(void* buffer, size_t buffer_size,
+                  std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+        , initial_buffer_(static_cast<std::byte*>(buffer))
+        , initial_buffer_size_(buffer_size)
+        , current_(initial_buffer_)
+        , end_(initial_buffer_ + buffer_size)
+        , next_block_size_(std::max(buffer_size * 2, MIN_BLOCK_SIZE)) {
+    }
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() override {
+        Release();
+    }
+
+    // Возвращает всю выделенную память. Все указатели, полученные от арены, становятся невалидными
+    void Release() noexcept {
+        while (blocks_ != nullptr) {
+            BlockHeader* next = blocks_->next;
+            upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+            blocks_ = next;
+        }
+        current_ = initial_buffer_;
+        end_ = initial_buffer_ + initial_buffer_size_;
+        bytes_allocated_ = 0;
+    }
+
+    // Количество байт, выданных арене пользователями с момента последнего Release
+    size_t BytesAllocated() const noexcept {
+        return bytes_allocated_;
+    }
+
+    std::pmr::memory_resource* GetUpstream() const noexcept {
+        return upstream_;
+    }
+
+private:
+    struct BlockHeader {
+        BlockHeader* next;
+        size_t size;
+    };
+
+    static constexpr size_t MIN_BLOCK_SIZE = 256;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* result = AlignedPointer(bytes, alignment);
+        if (result == nullptr) {
+            AddBlock(bytes + alignment);
+            result = AlignedPointer(bytes, alignment);
+            assert(result != nullptr);
+        }
+        current_ = static_cast<std::byte*>(result) + bytes;
+        bytes_allocated_ += bytes;
+        return result;
+    }
+
+    void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {
+        // Память возвращается только целиком через Release
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    // Возвращает выровненный адрес в текущем блоке либо nullptr, если места недостаточно
+    void* AlignedPointer(size_t bytes, size_t alignment) noexcept {
+        if (current_ == nullptr) {
+            return nullptr;
+        }
+        void* ptr = current_;
+        size_t space = static_cast<size_t>(end_ - current_);
+        return std::align(alignment, bytes, ptr, space);
+    }
+
+    void AddBlock(size_t min_payload) {
+        const size_t payload = std::max(next_block_size_, min_payload);
+        const size_t block_size = sizeof(BlockHeader) + payload;
+        auto* block = static_cast<BlockHeader*>(upstream_->allocate(block_size, alignof(std::max_align_t)));
+        block->next = blocks_;
+        block->size = block_size;
+        blocks_ = block;
+
+        current_ = reinterpret_cast<std::byte*>(block + 1);
+        end_ = reinterpret_cast<std::byte*>(block) + block_size;
+        next_block_size_ = payload * 2;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::byte* initial_buffer_ = nullptr;
+    size_t initial_buffer_size_ = 0;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t next_block_size_;
+    size_t bytes_allocated_ = 0;
+    BlockHeader* blocks_ = nullptr;
+};
+
+// Пул блоков фиксированного размера со списком свободных блоков. Запросы, не превышающие
+// block_size, обслуживаются за O(1) без обращения к куче, более крупные передаются в upstream.
+// Память пула нарезается кусками по blocks_per_chunk блоков. Класс не потокобезопасен.
+class FixedPoolResource : public std::pmr::memory_resource {
+public:
+    explicit FixedPoolResource(size_t block_size, size_t blocks_per_chunk = 64,
+                               std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+        , block_size_(RoundUp(std::max(block_size, sizeof(FreeBlock)), alignof(std::max_align_t)))
+        , blocks_per_chunk_(std::max<size_t>(blocks_per_chunk, 1)) {
+    }
+
+    FixedPoolResource(const FixedPoolResource&) = delete;
+    FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+    ~FixedPoolResource() override {
+        Release();
+    }
+
+    // Освобождает все куски пула. Крупные блоки, выделенные в upstream, не затрагиваются
+    void Release() noexcept {
+        while (chunks_ != nullptr) {
+            ChunkHeader* next = chunks_->next;
+            upstream_->deallocate(chunks_, ChunkSize(), alignof(std::max_align_t));
+            chunks_ = next;
+        }
+        free_list_ = nullptr;
+    }
+
+    size_t BlockSize() const noexcept {
+        return block_size_;
+    }
+
+    std::pmr::memory_resource* GetUpstream() const noexcept {
+        return upstream_;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct alignas(std::max_align_t) ChunkHeader {
+        ChunkHeader* next;
+    };
+
+    static constexpr size_t RoundUp(size_t value, size_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool IsPooled(size_t bytes, size_t alignment) const noexcept {
+        return bytes <= block_size_ && alignment <= alignof(std::max_align_t);
+    }
+
+    size_t ChunkSize() const noexcept {
+        return sizeof(ChunkHeader) + block_size_ * blocks_per_chunk_;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        if (free_list_ == nullptr) {
+            AddChunk();
+        }
+        FreeBlock* block = free_list_;
+        free_list_ = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void AddChunk() {
+        auto* chunk = static_cast<ChunkHeader*>(upstream_->allocate(ChunkSize(), alignof(std::max_align_t)));
+        chunk->next = chunks_;
+        chunks_ = chunk;
+
+        auto* first = reinterpret_cast<std::byte*>(chunk + 1);
+        for (size_t i = blocks_per_chunk_; i > 0; --i) {
+            auto* block = reinterpret_cast<FreeBlock*>(first + (i - 1) * block_size_);
+            block->next = free_list_;
+            free_list_ = block;
+        }
+    }
+
+    std::pmr::memory_resource* upstream_;
+    size_t block_size_;
+    size_t blocks_per_chunk_;
+    ChunkHeader* chunks_ = nullptr;
+    FreeBlock* free_list_ = nullptr;
+};
+
+namespace pmr {
+
+// Вектор, память которого берётся из произвольного std::pmr::memory_resource
+template <typename T, typename Growth = DoublingGrowth>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
+
+}  // namespace pmr
@@ -0,0 +1,404 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+
+// Вектор с разделяемым неизменяемым хранилищем и подсчётом ссылок (копирование при записи).
+// Копия стоит O(1) и не выделяет память: обе копии ссылаются на один блок RawMemory.
+// Каждый владелец видит свой префикс блока [0, Size()), поэтому элементы префикса не меняются,
+// пока блок разделён. Добавление в конец не копирует блок, если у блока есть запас вместимости
+// и Size() владельца совпадает с числом сконструированных в блоке элементов: слот за концом
+// занимается атомарным CAS и не виден другим владельцам. Так работает Snapshot(): читатели держат
+// согласованный префикс, а писатель продолжает добавлять элементы без копирования; при исчерпании
+// вместимости писатель переходит в новый блок, а старый живёт, пока его держит хотя бы один
+// читатель (отложенное освобождение в духе RCU). Остальные изменения (Mutable, PopBack,
+// уменьшение размера) отделяют владельца копированием его префикса, только если есть другие владельцы.
+// Разные объекты SharedVector можно использовать из разных потоков одновременно,
+// один объект — нет (как std::shared_ptr)
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SharedVector {
+public:
+    using allocator_type = typename RawMemory<T, Alloc>::allocator_type;
+    using const_iterator = const T*;
+    using iterator = const_iterator;
+
+    // Итераторы дают только чтение; изменяемый доступ — через Mutable
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Конструкторы
+    SharedVector() = default;
+
+    explicit SharedVector(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    SharedVector(std::initializer_list<T> init, const allocator_type& alloc = allocator_type())
+        : SharedVector(init.begin(), init.size(), alloc) {
+    }
+
+    explicit SharedVector(const Vector<T, Alloc, Growth>& other)
+        : SharedVector(other.begin(), other.Size(), other.GetAllocator()) {
+    }
+
+    // Забирает буфер вектора без копирования элементов (см. Vector::Release)
+    explicit SharedVector(Vector<T, Alloc, Growth>&& other)
+        : alloc_(other.GetAllocator()) {
+        if (other.Capacity() == 0) {
+            return;
+        }
+        block_ = NewBlock(0);
+        ReleasedBuffer<T> released = other.Release();
+        block_->memory.Adopt(released.data, released.capacity, released.deleter);
+        block_->size.store(released.size, std::memory_order_relaxed);
+        size_ = released.size;
+    }
+
+    // O(1): увеличивает счётчик ссылок блока
+    SharedVector(const SharedVector& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(other.block_)
+        , size_(other.size_) {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedVector(SharedVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(std::exchange(other.block_, nullptr))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~SharedVector() {
+        ReleaseBlock(block_);
+    }
+
+    // Присваивание только перевешивает блок и не требует присваивания аллокатора: блок
+    // освобождается тем аллокатором, которым выделен, а собственный аллокатор получателя
+    // меняется лишь при propagate_on_container_copy/move_assignment
+    SharedVector& operator=(const SharedVector& rhs) noexcept {
+        if (this != &rhs) {
+            if (rhs.block_ != nullptr) {
+                rhs.block_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+            ReleaseBlock(std::exchange(block_, rhs.block_));
+            size_ = rhs.size_;
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    SharedVector& operator=(SharedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            ReleaseBlock(std::exchange(block_, std::exchange(rhs.block_, nullptr)));
+            size_ = std::exchange(rhs.size_, 0);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    // Аллокаторы обмениваются только при propagate_on_container_swap, иначе они должны
+    // быть равны (как в RawMemory::Swap)
+    void Swap(SharedVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_ && "Swap of SharedVector with unequal allocators");
+        }
+        std::swap(block_, other.block_);
+        std::swap(size_, other.size_);
+        std::swap(growth_, other.growth_);
+    }
+
+    // Согласованный снимок текущего содержимого за O(1). Дальнейшие изменения этого вектора
+    // в снимке не видны
+    SharedVector Snapshot() const noexcept {
+        return *this;
+    }
+
+    // Копия содержимого в обычный Vector
+    Vector<T, Alloc, Growth> ToVector() const {
+        return Vector<T, Alloc, Growth>(begin(), end(), alloc_);
+    }
+
+    // Методы доступа
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->memory.Capacity() : 0;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Число владельцев блока (0 для вектора без памяти)
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    const T* Data() const noexcept {
+        return block_ != nullptr ? block_->memory.GetAddress() : nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    const T& At(size_t index) const {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "SharedVector::At: index out of range");
+        }
+        return Data()[index];
+    }
+
+    const T& front() const {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return Data()[0];
+    }
+
+    const T& back() const {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return Data()[size_ - 1];
+    }
+
+    // Изменяемый доступ. Если у блока есть другие владельцы, вектор сначала отделяется
+    T& Mutable(size_t index) {
+        assert(index < size_);
+        Detach();
+        return block_->memory[index];
+    }
+
+    T* MutableData() {
+        Detach();
+        return block_ != nullptr ? block_->memory.GetAddress() : nullptr;
+    }
+
+    // Отделяет вектор от других владельцев блока, копируя его элементы. Строгая гарантия
+    void Detach() {
+        if (block_ != nullptr && !Unique()) {
+            Reallocate(block_->memory.Capacity());
+        }
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity > Capacity()) {
+            Reallocate(capacity);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            if (Unique()) {
+                std::destroy_n(block_->memory + new_size, size_ - new_size);
+                block_->size.store(new_size, std::memory_order_relaxed);
+            }
+            size_ = new_size;
+            return;
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    // Разрушает элементы единственного владельца либо отказывается от разделённого блока
+    void Clear() noexcept {
+        if (block_ != nullptr && !Unique()) {
+            ReleaseBlock(std::exchange(block_, nullptr));
+        } else if (block_ != nullptr) {
+            std::destroy_n(block_->memory.GetAddress(), size_);
+            block_->size.store(0, std::memory_order_relaxed);
+        }
+        size_ = 0;
+    }
+
+    // Методы размещения и удаления. Аргументы могут ссылаться на элементы вектора.
+    // Строгая гарантия безопасности исключений
+    template <typename... Args>
+    const T& EmplaceBack(Args&&... args) {
+        if (block_ != nullptr && size_ < block_->memory.Capacity()) {
+            // Слот за концом свободен, если его ещё не занял другой владелец блока
+            size_t expected = size_;
+            if (block_->size.compare_exchange_strong(expected, size_ + 1, std::memory_order_acq_rel)) {
+                VECTOR_TRY {
+                    new (block_->memory + size_) T(std::forward<Args>(args)...);
+                } VECTOR_CATCH_ALL {
+                    block_->size.store(size_, std::memory_order_release);
+                    VECTOR_RETHROW;
+                }
+                return block_->memory[size_++];
+            }
+        }
+
+        Block* block = NewBlock(growth_.NextCapacity(size_, size_ + 1, sizeof(T)));
+        VECTOR_TRY {
+            new (block->memory + size_) T(std::forward<Args>(args)...);
+            VECTOR_TRY {
+                FillFrom(*block);
+            } VECTOR_CATCH_ALL {
+                std::destroy_at(block->memory + size_);
+                VECTOR_RETHROW;
+            }
+        } VECTOR_CATCH_ALL {
+            DeleteBlock(block);
+            VECTOR_RETHROW;
+        }
+        block->size.store(size_ + 1, std::memory_order_relaxed);
+        ReleaseBlock(std::exchange(block_, block));
+        return block_->memory[size_++];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // У единственного владельца разрушает последний элемент; разделённый блок не меняется
+    void PopBack() noexcept {
+        assert(size_ > 0 && "PopBack() called on empty vector");
+        --size_;
+        if (Unique()) {
+            std::destroy_at(block_->memory + size_);
+            block_->size.store(size_, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Блок хранилища. size — число сконструированных элементов: у разных владельцев префиксы
+    // могут быть короче, а разрушает элементы последний владелец
+    struct Block {
+        Block(size_t capacity, const allocator_type& alloc)
+            : memory(capacity, alloc) {
+        }
+
+        std::atomic<size_t> refs{1};
+        std::atomic<size_t> size{0};
+        RawMemory<T, Alloc> memory;
+    };
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using BlockAllocator = typename AllocTraits::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+    Block* NewBlock(size_t capacity) {
+        BlockAllocator alloc(alloc_);
+        Block* block = BlockTraits::allocate(alloc, 1);
+        VECTOR_TRY {
+            BlockTraits::construct(alloc, block, capacity, alloc_);
+        } VECTOR_CATCH_ALL {
+            BlockTraits::deallocate(alloc, block, 1);
+            VECTOR_RETHROW;
+        }
+        return block;
+    }
+
+    // Освобождает блок без разрушения элементов
+    // Аллокатор берётся из самого блока: после присваивания вектор может владеть блоком,
+    // выделенным чужим аллокатором
+    void DeleteBlock(Block* block) noexcept {
+        BlockAllocator alloc(block->memory.GetAllocator());
+        BlockTraits::destroy(alloc, block);
+        BlockTraits::deallocate(alloc, block, 1);
+    }
+
+    void ReleaseBlock(Block* block) noexcept {
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::destroy_n(block->memory.GetAddress(), block->size.load(std::memory_order_relaxed));
+            DeleteBlock(block);
+        }
+    }
+
+    // Истина, если других владельцев нет. Элементы за префиксом, добавленные владельцами,
+    // которых уже нет, разрушаются: после этого блок целиком принадлежит вектору
+    bool Unique() noexcept {
+        if (block_ == nullptr || block_->refs.load(std::memory_order_acquire) != 1) {
+            return false;
+        }
+        const size_t constructed = block_->size.load(std::memory_order_relaxed);
+        if (constructed > size_) {
+            std::destroy_n(block_->memory + size_, constructed - size_);
+            block_->size.store(size_, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Переносит элементы в block: у единственного владельца — RawMemory::RelocateN,
+    // иначе копированием. Старый блок остаётся без элементов либо нетронутым
+    void FillFrom(Block& block) {
+        if (block_ == nullptr) {
+            return;
+        }
+        if (Unique()) {
+            RawMemory<T, Alloc>::RelocateN(block_->memory.GetAddress(), size_, block.memory.GetAddress());
+            block_->size.store(0, std::memory_order_relaxed);
+        } else {
+            std::uninitialized_copy_n(block_->memory.GetAddress(), size_, block.memory.GetAddress());
+        }
+    }
+
+    void Reallocate(size_t capacity) {
+        Block* block = NewBlock(capacity);
+        VECTOR_TRY {
+            FillFrom(*block);
+        } VECTOR_CATCH_ALL {
+            DeleteBlock(block);
+            VECTOR_RETHROW;
+        }
+        block->size.store(size_, std::memory_order_relaxed);
+        ReleaseBlock(std::exchange(block_, block));
+    }
+
+    SharedVector(const T* first, size_t count, const allocator_type& alloc)
+        : alloc_(alloc) {
+        if (count == 0) {
+            return;
+        }
+        Block* block = NewBlock(count);
+        VECTOR_TRY {
+            std::uninitialized_copy_n(first, count, block->memory.GetAddress());
+        } VECTOR_CATCH_ALL {
+            DeleteBlock(block);
+            VECTOR_RETHROW;
+        }
+        block->size.store(count, std::memory_order_relaxed);
+        block_ = block;
+        size_ = count;
+    }
+
+    [[no_unique_address]] allocator_type alloc_;
+    Block* block_ = nullptr;
+    size_t size_ = 0;
+    [[no_unique_address]] Growth growth_;
+};
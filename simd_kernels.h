@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(VECTOR_DISABLE_SIMD)
+#define VECTOR_SIMD_AVX2 1
+#include <immintrin.h>
+#define VECTOR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VECTOR_SIMD_AVX2 0
+#endif
+
+// Ядра поиска, подсчёта, свёртки, сравнения и заполнения для массивов арифметических типов.
+// Для 32-битных целых и float на x86 выбирается AVX2-версия, если процессор её поддерживает
+// (проверка выполняется один раз во время работы программы), иначе или для прочих типов —
+// скалярный цикл. Векторные циклы сначала доходят скалярно до границы 32 байт и дальше
+// читают выровненными загрузками, поэтому на буферах AlignedAllocator пролог пуст.
+// Отличия от скалярных алгоритмов: сумма float складывается в другом порядке
+// (результат может отличаться в последних битах), а MinMax для массивов с NaN не определён
+namespace vector_simd {
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool IS_INT32 = std::is_integral_v<T> && sizeof(T) == 4;
+
+template <typename T>
+inline constexpr bool IS_FLOAT = std::is_same_v<T, float>;
+
+// Типы, для которых есть векторные ядра
+template <typename T>
+inline constexpr bool HAS_KERNELS = IS_INT32<T> || IS_FLOAT<T>;
+
+// Побайтовое равенство совпадает с operator== для целых, перечислений и указателей
+template <typename T>
+inline constexpr bool BITWISE_EQUALITY = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+#if VECTOR_SIMD_AVX2
+
+inline bool HasAvx2() noexcept {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+inline bool IsAligned32(const void* p) noexcept {
+    return reinterpret_cast<std::uintptr_t>(p) % 32 == 0;
+}
+
+// Маска равенства восьми элементов: бит i установлен, если элемент i равен соответствующему в needle
+template <typename T>
+VECTOR_TARGET_AVX2 inline unsigned EqualMask(const T* p, __m256i needle) noexcept {
+    if constexpr (IS_FLOAT<T>) {
+        const __m256 v = _mm256_load_ps(reinterpret_cast<const float*>(p));
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_castsi256_ps(needle), _CMP_EQ_OQ)));
+    } else {
+        const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, needle))));
+    }
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline __m256i Broadcast(T value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return _mm256_set1_epi32(static_cast<int>(bits));
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline const T* FindAvx2(const T* first, const T* last, T value) noexcept {
+    for (; first != last && !IsAligned32(first); ++first) {
+        if (*first == value) {
+            return first;
+        }
+    }
+    const __m256i needle = Broadcast(value);
+    for (; last - first >= 8; first += 8) {
+        if (const unsigned mask = EqualMask(first, needle)) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return std::find(first, last, value);
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline size_t CountAvx2(const T* first, const T* last, T value) noexcept {
+    size_t count = 0;
+    for (; first != last && !IsAligned32(first); ++first) {
+        count += *first == value;
+    }
+    const __m256i needle = Broadcast(value);
+    for (; last - first >= 8; first += 8) {
+        count += static_cast<size_t>(__builtin_popcount(EqualMask(first, needle)));
+    }
+    return count + static_cast<size_t>(std::count(first, last, value));
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline T SumAvx2(const T* first, const T* last) noexcept {
+    T head = T{};
+    for (; first != last && !IsAligned32(first); ++first) {
+        head += *first;
+    }
+    alignas(32) T lanes[8];
+    if constexpr (IS_FLOAT<T>) {
+        __m256 acc = _mm256_setzero_ps();
+        for (; last - first >= 8; first += 8) {
+            acc = _mm256_add_ps(acc, _mm256_load_ps(first));
+        }
+        _mm256_store_ps(lanes, acc);
+    } else {
+        // Целые складываются по модулю 2^32, как и в скалярном цикле беззнаковых
+        __m256i acc = _mm256_setzero_si256();
+        for (; last - first >= 8; first += 8) {
+            acc = _mm256_add_epi32(acc, _mm256_load_si256(reinterpret_cast<const __m256i*>(first)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    }
+    T result = head;
+    for (T lane : lanes) {
+        result += lane;
+    }
+    for (; first != last; ++first) {
+        result += *first;
+    }
+    return result;
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline std::pair<T, T> MinMaxAvx2(const T* first, const T* last) noexcept {
+    T min_value = *first;
+    T max_value = *first;
+    for (; first != last && !IsAligned32(first); ++first) {
+        min_value = std::min(min_value, *first);
+        max_value = std::max(max_value, *first);
+    }
+    if (last - first >= 8) {
+        alignas(32) T min_lanes[8];
+        alignas(32) T max_lanes[8];
+        if constexpr (IS_FLOAT<T>) {
+            __m256 min_acc = _mm256_set1_ps(min_value);
+            __m256 max_acc = _mm256_set1_ps(max_value);
+            for (; last - first >= 8; first += 8) {
+                const __m256 v = _mm256_load_ps(first);
+                min_acc = _mm256_min_ps(min_acc, v);
+                max_acc = _mm256_max_ps(max_acc, v);
+            }
+            _mm256_store_ps(min_lanes, min_acc);
+            _mm256_store_ps(max_lanes, max_acc);
+        } else {
+            __m256i min_acc = Broadcast(min_value);
+            __m256i max_acc = Broadcast(max_value);
+            for (; last - first >= 8; first += 8) {
+                const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(first));
+                if constexpr (std::is_signed_v<T>) {
+                    min_acc = _mm256_min_epi32(min_acc, v);
+                    max_acc = _mm256_max_epi32(max_acc, v);
+                } else {
+                    min_acc = _mm256_min_epu32(min_acc, v);
+                    max_acc = _mm256_max_epu32(max_acc, v);
+                }
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(min_lanes), min_acc);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(max_lanes), max_acc);
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            min_value = std::min(min_value, min_lanes[i]);
+            max_value = std::max(max_value, max_lanes[i]);
+        }
+    }
+    for (; first != last; ++first) {
+        min_value = std::min(min_value, *first);
+        max_value = std::max(max_value, *first);
+    }
+    return {min_value, max_value};
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline void FillAvx2(T* first, T* last, T value) noexcept {
+    for (; first != last && !IsAligned32(first); ++first) {
+        *first = value;
+    }
+    const __m256i pattern = Broadcast(value);
+    for (; last - first >= 8; first += 8) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(first), pattern);
+    }
+    std::fill(first, last, value);
+}
+
+template <typename T>
+VECTOR_TARGET_AVX2 inline void IotaAvx2(T* first, T* last, T value) noexcept {
+    for (; first != last && !IsAligned32(first); ++first) {
+        *first = value++;
+    }
+    __m256i current = _mm256_add_epi32(Broadcast(value), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+    for (; last - first >= 8; first += 8) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(first), current);
+        current = _mm256_add_epi32(current, step);
+        value += 8;
+    }
+    for (; first != last; ++first) {
+        *first = value++;
+    }
+}
+
+#endif  // VECTOR_SIMD_AVX2
+
+// Истина, если для T стоит вызывать векторное ядро
+template <typename T>
+inline bool UseAvx2() noexcept {
+#if VECTOR_SIMD_AVX2
+    return HAS_KERNELS<T> && HasAvx2();
+#else
+    return false;
+#endif
+}
+
+}  // namespace detail
+
+template <typename T>
+const T* Find(const T* first, const T* last, const T& value) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::HAS_KERNELS<T>) {
+        if (detail::UseAvx2<T>()) {
+            return detail::FindAvx2(first, last, value);
+        }
+    }
+#endif
+    return std::find(first, last, value);
+}
+
+template <typename T>
+size_t Count(const T* first, const T* last, const T& value) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::HAS_KERNELS<T>) {
+        if (detail::UseAvx2<T>()) {
+            return detail::CountAvx2(first, last, value);
+        }
+    }
+#endif
+    return static_cast<size_t>(std::count(first, last, value));
+}
+
+// Сумма элементов, начиная с T{}
+template <typename T>
+T Sum(const T* first, const T* last) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::HAS_KERNELS<T>) {
+        if (detail::UseAvx2<T>()) {
+            return detail::SumAvx2(first, last);
+        }
+    }
+#endif
+    T result = T{};
+    for (; first != last; ++first) {
+        result = result + *first;
+    }
+    return result;
+}
+
+// Минимум и максимум непустого диапазона
+template <typename T>
+std::pair<T, T> MinMax(const T* first, const T* last) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::HAS_KERNELS<T>) {
+        if (detail::UseAvx2<T>()) {
+            return detail::MinMaxAvx2(first, last);
+        }
+    }
+#endif
+    const auto [min_it, max_it] = std::minmax_element(first, last);
+    return {*min_it, *max_it};
+}
+
+template <typename T>
+bool Equal(const T* lhs, const T* rhs, size_t count) {
+    if constexpr (detail::BITWISE_EQUALITY<T>) {
+        // memcmp библиотеки C сам использует самые широкие доступные инструкции
+        return count == 0 || std::memcmp(lhs, rhs, count * sizeof(T)) == 0;
+    } else {
+        return std::equal(lhs, lhs + count, rhs);
+    }
+}
+
+template <typename T>
+void Fill(T* first, T* last, const T& value) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::HAS_KERNELS<T>) {
+        if (detail::UseAvx2<T>()) {
+            detail::FillAvx2(first, last, value);
+            return;
+        }
+    }
+#endif
+    std::fill(first, last, value);
+}
+
+// Заполняет диапазон значениями value, value + 1, ...
+template <typename T>
+void Iota(T* first, T* last, T value) {
+#if VECTOR_SIMD_AVX2
+    if constexpr (detail::IS_INT32<T>) {
+        if (detail::UseAvx2<T>()) {
+            detail::IotaAvx2(first, last, value);
+            return;
+        }
+    }
+#endif
+    for (; first != last; ++first) {
+        *first = value;
+        ++value;
+    }
+}
+
+}  // namespace vector_simd
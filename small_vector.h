@@ -0,0 +1,352 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+
+// Вектор с оптимизацией малого размера: первые N элементов размещаются во встроенном буфере
+// внутри объекта, и динамическая память выделяется только при переполнении буфера.
+// Интерфейс и гарантии безопасности исключений совпадают с Vector. Отличия:
+//  - вместимость пустого вектора равна N;
+//  - перемещение и Swap вектора, элементы которого находятся во встроенном буфере,
+//    переносят элементы поштучно и выполняются за O(N).
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector requires non-zero inline capacity");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Итераторы
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Конструкторы
+    SmallVector() noexcept {
+    }
+
+    explicit SmallVector(size_t size) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(begin(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (other.IsInline()) {
+            RawMemory<T>::RelocateN(other.begin(), other.size_, begin());
+        } else {
+            heap_.Swap(other.heap_);
+            SyncData();
+            other.SyncData();
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    ~SmallVector() {
+        std::destroy_n(begin(), size_);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if (rhs.size_ > Capacity()) {
+                // Строгая гарантия: копия строится в новом буфере, и старые элементы разрушаются
+                // только после её успеха. Встроенные элементы при этом не переносятся
+                RawMemory<T> new_data(rhs.size_);
+                std::uninitialized_copy_n(rhs.begin(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(begin(), size_);
+                heap_.Swap(new_data);
+                SyncData();
+                size_ = rhs.size_;
+            } else {
+                const size_t common_size = std::min(size_, rhs.size_);
+                std::copy_n(rhs.begin(), common_size, begin());
+
+                if (size_ < rhs.size_) {
+                    std::uninitialized_copy_n(rhs.begin() + size_, rhs.size_ - size_, end());
+                } else {
+                    std::destroy_n(begin() + rhs.size_, size_ - rhs.size_);
+                }
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Clear();
+            if (rhs.IsInline()) {
+                // Вместимость любого SmallVector не меньше N, поэтому элементы rhs помещаются
+                RawMemory<T>::RelocateN(rhs.begin(), rhs.size_, begin());
+            } else {
+                heap_.Swap(rhs.heap_);
+                SyncData();
+                rhs.SyncData();
+            }
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    // Обмен за O(1), если элементы обоих векторов находятся в динамической памяти
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return;
+        }
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Методы доступа
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает true, пока элементы размещаются во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.Capacity() == 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    T& front() {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return Data()[0];
+    }
+
+    const T& front() const {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return Data()[0];
+    }
+
+    T& back() {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return Data()[size_ - 1];
+    }
+
+    const T& back() const {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return Data()[size_ - 1];
+    }
+
+    T& At(size_t index) {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "SmallVector::At: index out of range");
+        }
+        return Data()[index];
+    }
+
+    const T& At(size_t index) const {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "SmallVector::At: index out of range");
+        }
+        return Data()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+
+        RawMemory<T> new_data(new_capacity);
+        RawMemory<T>::RelocateN(begin(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+        SyncData();
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(begin() + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(end(), new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Очистка содержимого вектора без освобождения памяти
+    void Clear() noexcept {
+        std::destroy_n(begin(), size_);
+        size_ = 0;
+    }
+
+    // Методы размещения и удаления
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0 && "PopBack() called on empty vector");
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end() && "Invalid position for Emplace");
+        size_t index = pos - begin();
+
+        if (size_ == Capacity()) {
+            EmplaceWithReallocation(index, std::forward<Args>(args)...);
+        } else {
+            EmplaceWithoutReallocation(index, std::forward<Args>(args)...);
+        }
+
+        ++size_;
+        return begin() + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= begin() && pos < end() && "Invalid position for Erase");
+
+        iterator mutable_pos = begin() + (pos - begin());
+        // Сдвигаем последующие элементы влево на одну поз. и разрушаем освободившийся последний
+        std::move(mutable_pos + 1, end(), mutable_pos);
+        PopBack();
+
+        return mutable_pos;
+    }
+
+private:
+    T* Data() noexcept {
+        return data_;
+    }
+
+    const T* Data() const noexcept {
+        return data_;
+    }
+
+    T* InlineData() noexcept {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    // Обновляет указатель на элементы после смены буфера
+    void SyncData() noexcept {
+        data_ = IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t index, Args&&... args) {
+        RawMemory<T> new_data(Capacity() * 2);
+
+        // Новый элемент конструируется до переноса: аргументы могут ссылаться на элементы вектора
+        T* new_element = new (new_data + index) T(std::forward<Args>(args)...);
+
+        if constexpr (IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>) {
+            RawMemory<T>::RelocateN(begin(), index, new_data.GetAddress());
+            RawMemory<T>::RelocateN(begin() + index, size_ - index, new_data.GetAddress() + index + 1);
+        } else {
+            VECTOR_TRY {
+                RawMemory<T>::MoveOrCopyN(begin(), index, new_data.GetAddress());
+            } VECTOR_CATCH_ALL {
+                std::destroy_at(new_element);
+                VECTOR_RETHROW;
+            }
+            VECTOR_TRY {
+                RawMemory<T>::MoveOrCopyN(begin() + index, size_ - index, new_data.GetAddress() + index + 1);
+            } VECTOR_CATCH_ALL {
+                std::destroy_n(new_data.GetAddress(), index + 1);
+                VECTOR_RETHROW;
+            }
+            std::destroy_n(begin(), size_);
+        }
+        heap_.Swap(new_data);
+        SyncData();
+    }
+
+    template <typename... Args>
+    void EmplaceWithoutReallocation(size_t index, Args&&... args) {
+        T* data = Data();
+        if (index == size_) {
+            new (data + size_) T(std::forward<Args>(args)...);
+        } else {
+            // Временный элемент защищает от аргументов, ссылающихся на сдвигаемые элементы
+            T temp(std::forward<Args>(args)...);
+            new (data + size_) T(std::move(data[size_ - 1]));
+
+            if constexpr (std::is_nothrow_move_assignable_v<T>) {
+                std::move_backward(data + index, data + size_ - 1, data + size_);
+                data[index] = std::move(temp);
+            } else {
+                VECTOR_TRY {
+                    std::move_backward(data + index, data + size_ - 1, data + size_);
+                    data[index] = std::move(temp);
+                } VECTOR_CATCH_ALL {
+                    std::destroy_at(data + size_);
+                    VECTOR_RETHROW;
+                }
+            }
+        }
+    }
+
+    // Пуст, пока элементы помещаются во встроенный буфер
+    RawMemory<T> heap_;
+    // Указывает на встроенный буфер либо на heap_, чтобы доступ к элементам не требовал ветвления
+    T* data_ = InlineData();
+    size_t size_ = 0;
+    alignas(T) std::byte inline_[N * sizeof(T)];
+};
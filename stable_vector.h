@@ -0,0 +1,459 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <iterator>
+
+// Сегментированный вектор со стабильными адресами элементов. Элементы хранятся в сегментах
+// RawMemory: сегмент k вмещает FirstSegmentSize << k элементов, поэтому добавление никогда
+// не переносит существующие элементы — указатели, ссылки и итераторы на них остаются
+// валидными до удаления самого элемента, а рост стоит O(1) без реаллокации данных.
+// Номер сегмента вычисляется по старшему биту индекса, так что доступ по индексу — O(1).
+// Внутри сегмента элементы лежат непрерывно: итерация идёт по крупным блокам, а ForEachSpan
+// отдаёт их целиком для векторизованных проходов.
+// Интерфейс повторяет Vector, кроме вставки и удаления в середине, которые потребовали бы
+// сдвига элементов и нарушили бы стабильность адресов
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegmentSize = 64>
+class StableVector {
+    static_assert(FirstSegmentSize > 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0,
+                  "FirstSegmentSize must be a power of two");
+
+    template <bool IsConst>
+    class Iterator;
+
+public:
+    using allocator_type = typename RawMemory<T, Alloc>::allocator_type;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Итераторы
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Конструкторы
+    StableVector() = default;
+
+    explicit StableVector(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    explicit StableVector(size_t size, const allocator_type& alloc = allocator_type())
+        : StableVector(alloc) {
+        Resize(size);
+    }
+
+    StableVector(std::initializer_list<T> init, const allocator_type& alloc = allocator_type())
+        : StableVector(alloc) {
+        Reserve(init.size());
+        for (const T& value : init) {
+            PushBack(value);
+        }
+    }
+
+    // Делегирующие конструкторы гарантируют вызов деструктора, если копирование прервётся
+    StableVector(const StableVector& other)
+        : StableVector(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        AppendCopy(other);
+    }
+
+    StableVector(StableVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~StableVector() {
+        Clear();
+    }
+
+    // Строгая гарантия: копия строится в памяти аллокатора получателя (или rhs при
+    // propagate_on_container_copy_assignment), затем обмениваются только сегменты
+    StableVector& operator=(const StableVector& rhs) {
+        if (this != &rhs) {
+            StableVector copy(AllocTraits::propagate_on_container_copy_assignment::value ? rhs.alloc_ : alloc_);
+            copy.AppendCopy(rhs);
+            SwapStorage(copy);
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    // Если аллокатор не распространяется при перемещении и аллокаторы не равны,
+    // элементы перемещаются поштучно в собственную память (как в Vector)
+    StableVector& operator=(StableVector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                StableVector(std::move(rhs)).SwapStorage(*this);
+                alloc_ = rhs.alloc_;
+            } else if (alloc_ == rhs.alloc_) {
+                StableVector(std::move(rhs)).SwapStorage(*this);
+            } else {
+                StableVector moved(alloc_);
+                moved.Reserve(rhs.size_);
+                for (T& value : rhs) {
+                    moved.PushBack(std::move(value));
+                }
+                SwapStorage(moved);
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    // Аллокаторы обмениваются только при propagate_on_container_swap, иначе они должны
+    // быть равны (как в RawMemory::Swap)
+    void Swap(StableVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_ && "Swap of StableVector with unequal allocators");
+        }
+        SwapStorage(other);
+    }
+
+    // Методы доступа
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Суммарная вместимость выделенных сегментов
+    size_t Capacity() const noexcept {
+        return SegmentStart(segments_.Size());
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Slot(index);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<StableVector&>(*this)[index];
+    }
+
+    T& At(size_t index) {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "StableVector::At: index out of range");
+        }
+        return Slot(index);
+    }
+
+    const T& At(size_t index) const {
+        return const_cast<StableVector&>(*this).At(index);
+    }
+
+    T& front() {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return Slot(0);
+    }
+
+    const T& front() const {
+        assert(size_ > 0 && "Cannot call front() on empty vector");
+        return Slot(0);
+    }
+
+    T& back() {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return Slot(size_ - 1);
+    }
+
+    const T& back() const {
+        assert(size_ > 0 && "Cannot call back() on empty vector");
+        return Slot(size_ - 1);
+    }
+
+    // Вызывает fn(Span<T>) для каждого непрерывного участка элементов в порядке индексов
+    template <typename Fn>
+    void ForEachSpan(Fn&& fn) {
+        for (size_t segment = 0; segment < segments_.Size() && SegmentStart(segment) < size_; ++segment) {
+            const size_t length = std::min(size_, SegmentStart(segment + 1)) - SegmentStart(segment);
+            fn(Span<T>(segments_[segment].GetAddress(), length));
+        }
+    }
+
+    template <typename Fn>
+    void ForEachSpan(Fn&& fn) const {
+        const_cast<StableVector&>(*this).ForEachSpan([&fn](Span<T> span) {
+            fn(Span<const T>(span.Data(), span.Size()));
+        });
+    }
+
+    // Выделяет сегменты, вмещающие не меньше capacity элементов. Элементы не переносятся
+    void Reserve(size_t capacity) {
+        while (Capacity() < capacity) {
+            AddSegment();
+        }
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    // Очистка содержимого вектора без освобождения памяти
+    void Clear() noexcept {
+        ForEachSpan([](Span<T> span) noexcept {
+            std::destroy(span.begin(), span.end());
+        });
+        size_ = 0;
+    }
+
+    // Освобождает сегменты, не содержащие элементов
+    void ShrinkToFit() noexcept {
+        while (!segments_.Empty() && SegmentStart(segments_.Size() - 1) >= size_) {
+            segments_.PopBack();
+        }
+    }
+
+    // Методы размещения и удаления. Добавление не меняет адресов существующих элементов,
+    // поэтому аргументы могут ссылаться на элементы вектора. Строгая гарантия безопасности
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            AddSegment();
+        }
+        T* slot = new (&Slot(size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0 && "PopBack() called on empty vector");
+        --size_;
+        std::destroy_at(&Slot(size_));
+    }
+
+private:
+    using AllocTraits = std::allocator_traits<allocator_type>;
+
+    static constexpr size_t FIRST_SEGMENT_SHIFT = vector_detail::HighestBit(FirstSegmentSize);
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    // Индекс первого элемента сегмента; он же суммарная вместимость предыдущих сегментов
+    static constexpr size_t SegmentStart(size_t segment) noexcept {
+        return SegmentSize(segment) - FirstSegmentSize;
+    }
+
+    static size_t SegmentOf(size_t index) noexcept {
+        return vector_detail::HighestBit(index + FirstSegmentSize) - FIRST_SEGMENT_SHIFT;
+    }
+
+    T& Slot(size_t index) const noexcept {
+        const size_t segment = SegmentOf(index);
+        return const_cast<T&>(segments_[segment][index - SegmentStart(segment)]);
+    }
+
+    void AddSegment() {
+        segments_.EmplaceBack(SegmentSize(segments_.Size()), alloc_);
+    }
+
+    void AppendCopy(const StableVector& other) {
+        Reserve(size_ + other.size_);
+        for (const T& value : other) {
+            PushBack(value);
+        }
+    }
+
+    // Сегменты освобождаются собственными аллокаторами, поэтому обмен не трогает alloc_
+    void SwapStorage(StableVector& other) noexcept {
+        segments_.Swap(other.segments_);
+        std::swap(size_, other.size_);
+    }
+
+    // Итератор произвольного доступа. Хранит указатель на текущий элемент и конец его сегмента,
+    // поэтому инкремент внутри сегмента сводится к сдвигу указателя
+    template <bool IsConst>
+    class Iterator {
+        using Owner = std::conditional_t<IsConst, const StableVector, StableVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+
+        // Преобразование iterator в const_iterator
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_)
+            , ptr_(other.ptr_)
+            , segment_end_(other.segment_end_) {
+        }
+
+        reference operator*() const noexcept {
+            return *ptr_;
+        }
+
+        pointer operator->() const noexcept {
+            return ptr_;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            if (++ptr_ == segment_end_) {
+                Locate();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        Iterator& operator--() noexcept {
+            --index_;
+            Locate();
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept {
+            Iterator copy(*this);
+            --*this;
+            return copy;
+        }
+
+        Iterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            Locate();
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type offset) noexcept {
+            return *this += -offset;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend Iterator operator+(difference_type offset, Iterator it) noexcept {
+            return it += offset;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class StableVector;
+
+        Iterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+            Locate();
+        }
+
+        // Находит элемент index_ и конец его сегмента. За пределами выделенных сегментов
+        // указатель не определён: такой итератор можно только сравнивать и сдвигать
+        void Locate() noexcept {
+            if (index_ >= owner_->Capacity()) {
+                ptr_ = nullptr;
+                segment_end_ = nullptr;
+                return;
+            }
+            const size_t segment = SegmentOf(index_);
+            ptr_ = &owner_->Slot(index_);
+            segment_end_ = ptr_ + (SegmentStart(segment + 1) - index_);
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+        pointer ptr_ = nullptr;
+        pointer segment_end_ = nullptr;
+
+        template <bool>
+        friend class Iterator;
+    };
+
+    [[no_unique_address]] allocator_type alloc_;
+    // Сегменты в порядке номеров; вектор перемещает лишь дескрипторы RawMemory, не элементы
+    Vector<RawMemory<T, Alloc>> segments_;
+    size_t size_ = 0;
+};
@@ -1,43 +1,333 @@
 #pragma once
 
 #include <cassert>
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <new>
 #include <utility>
 #include <memory>
 #include <optional>
 #include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#include "simd_kernels.h"
+#include "vector_stats.h"
+
+// Поддержка сборки без исключений (-fno-exceptions). В этом режиме блоки VECTOR_TRY не перехватывают
+// ничего, а ошибки, о которых Vector сообщает исключениями, передаются обработчику VectorErrorHandler
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define VECTOR_EXCEPTIONS 1
+#define VECTOR_TRY try
+#define VECTOR_CATCH_ALL catch (...)
+#define VECTOR_RETHROW throw
+#else
+#define VECTOR_EXCEPTIONS 0
+#define VECTOR_TRY if (true)
+#define VECTOR_CATCH_ALL else
+#define VECTOR_RETHROW ((void)0)
+#endif
+
+// Редкие ветви (реаллокация) выносятся из горячих методов, чтобы те встраивались целиком
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_NOINLINE __attribute__((noinline))
+#else
+#define VECTOR_NOINLINE
+#endif
+
+// В C++20 основные операции Vector и RawMemory с std::allocator доступны во время компиляции:
+// память выделяется через allocator_traits, элементы конструируются std::construct_at.
+// Параллельные операции, SIMD-алгоритмы, Adopt/Release и статистика остаются только во время выполнения
+#if __cplusplus >= 202002L && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define VECTOR_HAS_CONSTEXPR 1
+#define VECTOR_CONSTEXPR constexpr
+#else
+#define VECTOR_HAS_CONSTEXPR 0
+#define VECTOR_CONSTEXPR
+#endif
+
+// Ошибки контейнеров, которые в сборке с исключениями выбрасываются как стандартные исключения
+enum class VectorError {
+    OUT_OF_RANGE,          // std::out_of_range: At с недопустимым индексом
+    LENGTH_ERROR,          // std::length_error: запрошенная вместимость больше max_size
+    BAD_ALLOC,             // std::bad_alloc: аллокатору не хватило памяти
+    BAD_ARRAY_NEW_LENGTH,  // std::bad_array_new_length: размер блока в байтах не помещается в size_t
+    SYSTEM_ERROR,          // std::system_error с кодом из errno: отказ системного вызова
+    FORMAT_ERROR,          // std::runtime_error: повреждённые или несовместимые сериализованные данные
+};
+
+// Обработчик ошибок. Может завершить программу, выбросить собственное исключение или вернуть
+// управление: тогда выбрасывается стандартное исключение, а без исключений вызывается std::abort
+using VectorErrorHandler = void (*)(VectorError error, const char* message);
+
+namespace vector_detail {
+
+inline VectorErrorHandler& ErrorHandlerSlot() noexcept {
+    static VectorErrorHandler handler = nullptr;
+    return handler;
+}
+
+}  // namespace vector_detail
+
+// Устанавливает обработчик ошибок (nullptr — поведение по умолчанию) и возвращает предыдущий
+inline VectorErrorHandler SetVectorErrorHandler(VectorErrorHandler handler) noexcept {
+    return std::exchange(vector_detail::ErrorHandlerSlot(), handler);
+}
+
+// Сообщает об ошибке: вызывает обработчик, затем выбрасывает соответствующее исключение
+// либо, в сборке без исключений, аварийно завершает программу
+[[noreturn]] inline void ReportVectorError(VectorError error, const char* message) {
+    [[maybe_unused]] const int saved_errno = errno;
+    if (VectorErrorHandler handler = vector_detail::ErrorHandlerSlot()) {
+        handler(error, message);
+    }
+#if VECTOR_EXCEPTIONS
+    switch (error) {
+        case VectorError::OUT_OF_RANGE:
+            throw std::out_of_range(message);
+        case VectorError::LENGTH_ERROR:
+            throw std::length_error(message);
+        case VectorError::BAD_ARRAY_NEW_LENGTH:
+            throw std::bad_array_new_length();
+        case VectorError::SYSTEM_ERROR:
+            throw std::system_error(saved_errno, std::generic_category(), message);
+        case VectorError::FORMAT_ERROR:
+            throw std::runtime_error(message);
+        case VectorError::BAD_ALLOC:
+            break;
+    }
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+// Признак тривиальной перемещаемости (trivially relocatable): перенос объекта в другую память
+// можно выполнить побайтовым копированием, после которого исходный объект считается
+// несуществующим и не требует вызова деструктора. По умолчанию признак истинен для тривиально
+// копируемых типов. Пользовательские типы (дескрипторы, владеющие указателем, структуры из
+// тривиальных полей и таких дескрипторов) могут включить его специализацией:
+//     template <> struct IsTriviallyRelocatable<MyHandle> : std::true_type {};
+// Не специализируйте признак для типов, хранящих указатели на собственные поля
+// (например, std::string из libstdc++ с оптимизацией коротких строк).
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// std::unique_ptr со стандартным удалителем хранит только указатель
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Признак наличия у аллокатора метода
+//     T* reallocate(T* p, size_t old_n, size_t new_n) noexcept,
+// который меняет размер блока, сохраняя его содержимое побайтово (например, через mremap).
+// При невозможности метод возвращает nullptr и оставляет блок p нетронутым
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename Alloc::value_type*>(), size_t{}, size_t{}))>> : std::true_type {};
+
+// Признак наличия у аллокатора метода
+//     bool try_expand(T* p, size_t old_n, size_t new_n) noexcept,
+// который расширяет блок на месте, не перемещая его (например, через xallocx из jemalloc).
+// Элементы при этом остаются по прежним адресам, поэтому расширение допустимо для любого T
+template <typename Alloc, typename = void>
+struct HasTryExpand : std::false_type {};
+
+template <typename Alloc>
+struct HasTryExpand<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_expand(
+    std::declval<typename Alloc::value_type*>(), size_t{}, size_t{}))>> : std::true_type {};
+
+// Признак наличия у аллокатора метода allocate_at_least(n) в духе C++23: он возвращает
+// структуру с полями ptr и count, где count >= n — фактическая вместимость блока, которую
+// затем нужно передать в deallocate
+template <typename Alloc, typename = void>
+struct HasAllocateAtLeast : std::false_type {};
+
+template <typename Alloc>
+struct HasAllocateAtLeast<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(size_t{}).ptr),
+                                             decltype(std::declval<Alloc&>().allocate_at_least(size_t{}).count)>>
+    : std::true_type {};
+
+// Функция освобождения буфера, выделенного не аллокатором RawMemory (см. RawMemory::Adopt):
+// function(buffer, capacity, context), где capacity — вместимость в элементах.
+// Пустой объект означает, что буфер принадлежит аллокатору
+template <typename T>
+struct BufferDeleter {
+    using Function = void (*)(T* buffer, size_t capacity, void* context) noexcept;
+
+    Function function = nullptr;
+    void* context = nullptr;
+
+    constexpr explicit operator bool() const noexcept {
+        return function != nullptr;
+    }
+
+    void operator()(T* buffer, size_t capacity) const noexcept {
+        function(buffer, capacity, context);
+    }
+};
+
+// Буфер, отданный вызывающему методом Release. Первые size элементов сконструированы,
+// их разрушение и освобождение памяти через deleter — забота нового владельца
+template <typename T>
+struct ReleasedBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+    BufferDeleter<T> deleter;
+};
+
+namespace vector_detail {
+
+// Истина при вычислении во время компиляции: тогда memcpy, memmove и счётчики VectorStats недоступны
+constexpr bool IsConstantEvaluated() noexcept {
+#if VECTOR_HAS_CONSTEXPR
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+template <typename T, typename... Args>
+VECTOR_CONSTEXPR T* ConstructAt(T* place, Args&&... args) {
+#if VECTOR_HAS_CONSTEXPR
+    return std::construct_at(place, std::forward<Args>(args)...);
+#else
+    return ::new (static_cast<void*>(place)) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Разрушение count элементов; для тривиально разрушаемых типов цикл не порождается вовсе
+template <typename T>
+VECTOR_CONSTEXPR void DestroyN(T* first, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy_n(first, count);
+    }
+}
+
+// Аналоги std::uninitialized_*_n, допустимые во время компиляции (стандартные алгоритмы
+// становятся constexpr только в C++26). Во время выполнения вызывают стандартные алгоритмы.
+// Во время компиляции исключение — ошибка вычисления, поэтому откат там не нужен
+template <typename InputIt, typename T>
+VECTOR_CONSTEXPR T* UninitializedCopyN(InputIt first, size_t count, T* to) {
+    if (IsConstantEvaluated()) {
+        for (; count != 0; --count, ++first, ++to) {
+            ConstructAt(to, *first);
+        }
+        return to;
+    }
+    return std::uninitialized_copy_n(first, count, to);
+}
+
+template <typename T>
+VECTOR_CONSTEXPR T* UninitializedMoveN(T* first, size_t count, T* to) {
+    if (IsConstantEvaluated()) {
+        for (; count != 0; --count, ++first, ++to) {
+            ConstructAt(to, std::move(*first));
+        }
+        return to;
+    }
+    return std::uninitialized_move_n(first, count, to).second;
+}
+
+template <typename T>
+VECTOR_CONSTEXPR T* UninitializedFillN(T* to, size_t count, const T& value) {
+    if (IsConstantEvaluated()) {
+        for (; count != 0; --count, ++to) {
+            ConstructAt(to, value);
+        }
+        return to;
+    }
+    return std::uninitialized_fill_n(to, count, value);
+}
+
+template <typename T>
+VECTOR_CONSTEXPR T* UninitializedValueConstructN(T* to, size_t count) {
+    if (IsConstantEvaluated()) {
+        for (; count != 0; --count, ++to) {
+            ConstructAt(to);
+        }
+        return to;
+    }
+    return std::uninitialized_value_construct_n(to, count);
+}
 
+// Во время компиляции неинициализированное значение читать нельзя, поэтому элементы
+// инициализируются значением
 template <typename T>
+VECTOR_CONSTEXPR T* UninitializedDefaultConstructN(T* to, size_t count) {
+    if (IsConstantEvaluated()) {
+        return UninitializedValueConstructN(to, count);
+    }
+    return std::uninitialized_default_construct_n(to, count);
+}
+
+}  // namespace vector_detail
+
+// Сырая память под элементы типа T, выделяемая через аллокатор Alloc.
+// Alloc должен удовлетворять требованиям std::allocator_traits, поэтому подходят как
+// std::allocator, так и std::pmr::polymorphic_allocator поверх любого memory_resource.
+// Аллокатор отвечает только за выделение и освобождение памяти: элементы конструируются
+// владельцем RawMemory при помощи размещающего new.
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory {
+public:
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+private:
+    using AllocTraits = std::allocator_traits<allocator_type>;
+
 public:
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
+    VECTOR_CONSTEXPR explicit RawMemory(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    // Выделяет память не менее чем под capacity элементов. Если аллокатор сообщает фактический
+    // размер блока (см. HasAllocateAtLeast), вместимость может оказаться больше запрошенной
+    VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        Allocate(capacity);
+    }
+
+    VECTOR_CONSTEXPR ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory&) = delete;
 
-    RawMemory(RawMemory&& other) noexcept
-        : buffer_(other.buffer_)
-        , capacity_(other.capacity_) {
+    VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(other.buffer_)
+        , capacity_(other.capacity_)
+        , deleter_(std::exchange(other.deleter_, {})) {
         other.buffer_ = nullptr;
         other.capacity_ = 0;
     }
     
-    RawMemory& operator=(RawMemory&& other) noexcept {
+    VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& other) noexcept {
         if (this != &other) {
-            Deallocate(buffer_);  // Освобождаем текущие ресурсы
+            Deallocate(buffer_, capacity_);  // Освобождаем текущие ресурсы
+            MoveAllocatorFrom(other);
         
             buffer_ = other.buffer_;
             capacity_ = other.capacity_;
+            deleter_ = std::exchange(other.deleter_, {});
             
             other.buffer_ = nullptr;
             other.capacity_ = 0;
@@ -46,266 +336,1062 @@ public:
         return *this;
     }    
 
-    T* operator+(size_t offset) noexcept {
+    VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    // Обмен буферами. Аллокаторы обмениваются, только если этого требует
+    // propagate_on_container_swap, иначе они обязаны быть равны
+    VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_ && "Swap of RawMemory with unequal allocators");
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
+        std::swap(deleter_, other.deleter_);
+    }
+
+    // Освобождает текущий буфер и принимает во владение buffer вместимостью capacity элементов.
+    // Буфер будет освобождён вызовом deleter; пустой deleter означает, что buffer выделен
+    // аллокатором, равным аллокатору этого объекта (например, получен ранее через Release)
+    void Adopt(T* buffer, size_t capacity, BufferDeleter<T> deleter = {}) noexcept {
+        assert((buffer != nullptr || capacity == 0) && "Adopt of null buffer with non-zero capacity");
+        Deallocate(buffer_, capacity_);
+        buffer_ = buffer;
+        capacity_ = capacity;
+        deleter_ = deleter;
+    }
+
+    // Отдаёт буфер вызывающему, оставляя RawMemory пустым. Для буфера, выделенного аллокатором,
+    // возвращается deleter, освобождающий его этим же аллокатором, если аллокатор не имеет
+    // состояния (is_always_equal); иначе deleter пуст и память освобождается копией GetAllocator()
+    ReleasedBuffer<T> Release() noexcept {
+        ReleasedBuffer<T> result;
+        result.data = std::exchange(buffer_, nullptr);
+        result.capacity = std::exchange(capacity_, 0);
+        result.deleter = std::exchange(deleter_, {});
+        if constexpr (AllocTraits::is_always_equal::value && std::is_default_constructible_v<allocator_type>) {
+            if (!result.deleter && result.data != nullptr) {
+                result.deleter.function = &DeallocateWithDefaultAllocator;
+            }
+        }
+        return result;
+    }
+
+    // Истина, если буфер принадлежит внешнему владельцу (см. Adopt)
+    VECTOR_CONSTEXPR bool IsAdopted() const noexcept {
+        return static_cast<bool>(deleter_);
     }
 
-    const T* GetAddress() const noexcept {
+    VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    VECTOR_CONSTEXPR T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    VECTOR_CONSTEXPR size_t Capacity() const {
         return capacity_;
     }
 
+    VECTOR_CONSTEXPR allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Истина, если вместимость можно менять средствами аллокатора (см. HasReallocate):
+    // это допустимо только для тривиально перемещаемых элементов
+    static constexpr bool CAN_REALLOCATE = IsTriviallyRelocatableV<T> && HasReallocate<allocator_type>::value;
+
+    // Увеличивает вместимость непустого буфера на месте через try_expand аллокатора (см. HasTryExpand).
+    // Адрес буфера и элементы не меняются. Возвращает false, если расширение невозможно
+    // или буфер внешний (см. Adopt)
+    VECTOR_CONSTEXPR bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (HasTryExpand<allocator_type>::value) {
+            if (buffer_ != nullptr && !deleter_ && new_capacity > capacity_ &&
+                alloc_.try_expand(buffer_, capacity_, new_capacity)) {
+                VectorStats::RecordBlockResize(capacity_ * sizeof(T), new_capacity * sizeof(T));
+                capacity_ = new_capacity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Меняет вместимость непустого буфера через reallocate аллокатора, сохраняя его содержимое.
+    // Возвращает false, если аллокатор этого не поддерживает или не смог либо буфер внешний,
+    // буфер при этом не меняется
+    VECTOR_CONSTEXPR bool Reallocate(size_t new_capacity) noexcept {
+        if constexpr (CAN_REALLOCATE) {
+            if (buffer_ != nullptr && !deleter_ && new_capacity != 0) {
+                if (T* buffer = alloc_.reallocate(buffer_, capacity_, new_capacity)) {
+                    VectorStats::RecordBlockResize(capacity_ * sizeof(T), new_capacity * sizeof(T));
+                    buffer_ = buffer;
+                    capacity_ = new_capacity;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Конструирует в неинициализированной памяти to копии или перемещённые значения count
+    // элементов из from. Перемещение выбирается, если оно noexcept или тип не копируется.
+    // Исходные элементы не разрушаются
+    static VECTOR_CONSTEXPR void MoveOrCopyN(T* from, size_t count, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            vector_detail::UninitializedMoveN(from, count, to);
+            if (!vector_detail::IsConstantEvaluated()) {
+                VectorStats::RecordMoved(count);
+            }
+        } else {
+            vector_detail::UninitializedCopyN(from, count, to);
+            if (!vector_detail::IsConstantEvaluated()) {
+                VectorStats::RecordCopied(count);
+            }
+        }
+    }
+
+    // Переносит count элементов из from в неинициализированную память to: после возврата
+    // элементы живут по адресу to, а память from свободна. Для тривиально перемещаемых типов
+    // это один memcpy без цикла деструкторов. Иначе элементы перемещаются либо копируются
+    // (см. MoveOrCopyN), и исходные разрушаются только после успешного переноса всех элементов,
+    // поэтому при исключении во время копирования диапазон from остаётся нетронутым.
+    // Во время компиляции memcpy недоступен, и элементы переносятся перемещением
+    static VECTOR_CONSTEXPR void RelocateN(T* from, size_t count, T* to) {
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            if (!vector_detail::IsConstantEvaluated()) {
+                if (count != 0) {
+                    std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+                    VectorStats::RecordRelocatedBitwise(count);
+                }
+                return;
+            }
+        }
+        MoveOrCopyN(from, count, to);
+        vector_detail::DestroyN(from, count);
+    }
+
 private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    // Выделяет сырую память не менее чем под n элементов и делает её буфером. Предыдущий буфер
+    // должен быть пуст
+    VECTOR_CONSTEXPR void Allocate(size_t n) {
+        if (n == 0) {
+            return;
+        }
+        if (n > AllocTraits::max_size(alloc_)) {
+            ReportVectorError(VectorError::LENGTH_ERROR, "RawMemory: capacity exceeds max_size");
+        }
+        T* buffer = nullptr;
+        if (vector_detail::IsConstantEvaluated()) {
+            // Во время компиляции память выделяется только через allocator_traits
+            buffer = AllocTraits::allocate(alloc_, n);
+            buffer_ = buffer;
+            capacity_ = n;
+            return;
+        }
+        if constexpr (!VECTOR_EXCEPTIONS && std::is_same_v<allocator_type, std::allocator<T>>) {
+            // Без исключений operator new не может сообщить о нехватке памяти: используем nothrow-версию,
+            // совместимую по освобождению с std::allocator::deallocate
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                buffer = static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{alignof(T)}, std::nothrow));
+            } else {
+                buffer = static_cast<T*>(operator new(n * sizeof(T), std::nothrow));
+            }
+            if (buffer == nullptr) {
+                ReportVectorError(VectorError::BAD_ALLOC, "RawMemory: out of memory");
+            }
+        } else if constexpr (HasAllocateAtLeast<allocator_type>::value) {
+            auto result = alloc_.allocate_at_least(n);
+            buffer = result.ptr;
+            n = result.count;
+        } else {
+            buffer = AllocTraits::allocate(alloc_, n);
+        }
+        VectorStats::RecordAllocation(n * sizeof(T));
+        buffer_ = buffer;
+        capacity_ = n;
+    }
+
+    // Освобождает сырую память под n элементов по адресу buf: внешний буфер — через deleter_,
+    // иначе аллокатором, которым он был выделен в Allocate
+    VECTOR_CONSTEXPR void Deallocate(T* buf, size_t n) noexcept {
+        if (deleter_) {
+            std::exchange(deleter_, {})(buf, n);
+        } else if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+            if (!vector_detail::IsConstantEvaluated()) {
+                VectorStats::RecordDeallocation(n * sizeof(T));
+            }
+        }
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    static void DeallocateWithDefaultAllocator(T* buffer, size_t capacity, void* /*context*/) noexcept {
+        allocator_type alloc;
+        AllocTraits::deallocate(alloc, buffer, capacity);
+        VectorStats::RecordDeallocation(capacity * sizeof(T));
     }
 
+    VECTOR_CONSTEXPR void MoveAllocatorFrom(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_ && "Move of RawMemory between unequal allocators");
+        }
+    }
+
+    [[no_unique_address]] allocator_type alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
+    // Непуст, если буфер принят через Adopt и освобождается внешним владельцем
+    BufferDeleter<T> deleter_;
+};
+
+// Политики роста вместимости при реаллокации в Emplace/EmplaceBack/PushBack.
+// Политика — объект с методом
+//     size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept,
+// возвращающим новую вместимость не меньше required. Вектор хранит объект политики,
+// поэтому политика может иметь состояние; пустые политики места не занимают.
+
+// Удвоение вместимости, начиная с 1. Политика по умолчанию
+struct DoublingGrowth {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) const noexcept {
+        if (capacity == 0) {
+            return std::max<size_t>(required, 1);
+        }
+        const size_t doubled = capacity > std::numeric_limits<size_t>::max() / 2
+            ? std::numeric_limits<size_t>::max() : capacity * 2;
+        return std::max(doubled, required);
+    }
+};
+
+// Рост в Num/Den раз (по умолчанию 1.5). При коэффициенте меньше золотого сечения суммарный
+// размер ранее освобождённых блоков со временем превышает новый запрос, и аллокатор может
+// переиспользовать их
+template <size_t Num = 3, size_t Den = 2>
+struct FactorGrowth {
+    static_assert(Num > Den && Den > 0, "Growth factor must be greater than 1");
+
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) const noexcept {
+        const size_t increment = std::max<size_t>(capacity / Den * (Num - Den) + capacity % Den * (Num - Den) / Den, 1);
+        const size_t grown = capacity > std::numeric_limits<size_t>::max() - increment
+            ? std::numeric_limits<size_t>::max() : capacity + increment;
+        return std::max(grown, required);
+    }
+};
+
+// Первая аллокация занимает не меньше одной кеш-линии (LineSize байт), далее действует Base
+template <typename Base = DoublingGrowth, size_t LineSize = 64>
+struct CacheLineGrowth {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept {
+        if (capacity == 0) {
+            return std::max<size_t>(required, std::max<size_t>(LineSize / element_size, 1));
+        }
+        return base.NextCapacity(capacity, required, element_size);
+    }
+
+    [[no_unique_address]] Base base;
+};
+
+// Пока буфер меньше ThresholdBytes, действует Base; дальше вместимость растёт линейно
+// на StepBytes. Ограничивает пиковое потребление памяти при реаллокации очень больших векторов
+template <size_t ThresholdBytes = (size_t{64} << 20), size_t StepBytes = (size_t{64} << 20),
+          typename Base = DoublingGrowth>
+struct CappedGrowth {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept {
+        if (capacity < ThresholdBytes / element_size) {
+            return std::min(base.NextCapacity(capacity, required, element_size),
+                            std::max(ThresholdBytes / element_size, required));
+        }
+        const size_t step = std::max<size_t>(StepBytes / element_size, 1);
+        const size_t grown = capacity > std::numeric_limits<size_t>::max() - step
+            ? std::numeric_limits<size_t>::max() : capacity + step;
+        return std::max(grown, required);
+    }
+
+    [[no_unique_address]] Base base;
+};
+
+// Политика роста может дополнительно определять метод
+//     size_t OnClear(size_t size_before_clear, size_t capacity) noexcept,
+// который вызывается из Vector::Clear и возвращает желаемую вместимость пустого вектора.
+// Если она меньше текущей, вектор освобождает буфер и резервирует возвращённую вместимость
+template <typename Growth, typename = void>
+struct HasOnClear : std::false_type {};
+
+template <typename Growth>
+struct HasOnClear<Growth, std::void_t<decltype(std::declval<Growth&>().OnClear(size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Рост как у Base плюс ограничение вместимости по «высокой воде»: если Streak вызовов Clear
+// подряд размер вектора перед очисткой не превышал capacity / Ratio, вместимость уменьшается
+// до максимального размера за эту серию. Так долгоживущий вектор, однажды переживший
+// всплеск, со временем возвращает память, но не теряет вместимость, нужную в обычном режиме
+template <typename Base = DoublingGrowth, size_t Ratio = 4, size_t Streak = 16>
+class TrimmingGrowth {
+    static_assert(Ratio > 1 && Streak > 0, "Invalid trimming parameters");
+
+public:
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept {
+        return base_.NextCapacity(capacity, required, element_size);
+    }
+
+    size_t OnClear(size_t size_before_clear, size_t capacity) noexcept {
+        if (size_before_clear > capacity / Ratio) {
+            streak_ = 0;
+            high_water_ = 0;
+            return capacity;
+        }
+        high_water_ = std::max(high_water_, size_before_clear);
+        if (++streak_ < Streak) {
+            return capacity;
+        }
+        streak_ = 0;
+        return std::exchange(high_water_, 0);
+    }
+
+private:
+    [[no_unique_address]] Base base_;
+    size_t streak_ = 0;
+    size_t high_water_ = 0;
 };
 
+// Ограничение шаблонов, принимающих пару итераторов: без него вызов Insert(pos, 5, 3)
+// для Vector<int> выбрал бы перегрузку для диапазона вместо Insert(pos, count, value)
+template <typename It>
+using RequireInputIterator = std::enable_if_t<std::is_convertible_v<
+    typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>>;
+
+template <typename It>
+inline constexpr bool IsForwardIteratorV = std::is_convertible_v<
+    typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// Тег конструктора Vector(size, default_init): элементы инициализируются по умолчанию,
+// а не значением, поэтому память под тривиальные типы не обнуляется и не затрагивается
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag default_init{};
+
+namespace vector_detail {
+
+// Номер старшего единичного бита ненулевого value (floor(log2(value)))
+constexpr size_t HighestBit(size_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value);
+#else
+    size_t result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+}  // namespace vector_detail
+
+// Тег параллельных операций: Vector(size, parallel), Vector(other, parallel), ParallelCopyFrom,
+// ParallelClear. Диапазон делится на части не меньше min_chunk_bytes, каждая обрабатывается
+// своим потоком; число потоков ограничено max_threads (0 — std::thread::hardware_concurrency)
+struct ParallelTag {
+    constexpr explicit ParallelTag(size_t max_threads = 0, size_t min_chunk_bytes = size_t{1} << 20) noexcept
+        : max_threads(max_threads)
+        , min_chunk_bytes(min_chunk_bytes) {
+    }
+
+    size_t max_threads;
+    size_t min_chunk_bytes;
+};
+
+inline constexpr ParallelTag parallel{};
+
+namespace vector_detail {
+
+// Применяет apply(first, last) к частям диапазона [0, count) элементов размера element_size:
+// первая часть обрабатывается вызывающим потоком, остальные — дополнительными потоками.
+// Если apply выбросил исключение хотя бы в одной части, после завершения всех потоков
+// для каждой успешно обработанной части вызывается undo(first, last) и первое исключение
+// выбрасывается повторно. apply должен сам откатывать свою часть при исключении, undo — noexcept.
+// Если поток создать не удалось, его часть обрабатывается вызывающим потоком.
+// Служебные массивы размещаются на стеке, поэтому сама функция память в куче не выделяет
+inline constexpr size_t MAX_PARALLEL_CHUNKS = 256;
+
+template <typename Apply, typename Undo>
+void ParallelApply(size_t count, size_t element_size, ParallelTag tag, Apply&& apply, Undo&& undo) {
+    const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t max_threads = tag.max_threads != 0 ? tag.max_threads : hardware;
+    const size_t min_chunk = std::max<size_t>(tag.min_chunk_bytes / std::max<size_t>(element_size, 1), 1);
+    const size_t chunks = std::clamp<size_t>(std::min(max_threads, count / min_chunk), 1, MAX_PARALLEL_CHUNKS);
+    if (chunks == 1) {
+        apply(size_t{0}, count);
+        return;
+    }
+
+    const auto chunk_begin = [count, chunks](size_t chunk) {
+        return count / chunks * chunk + std::min(chunk, count % chunks);
+    };
+#if VECTOR_EXCEPTIONS
+    std::exception_ptr errors[MAX_PARALLEL_CHUNKS];
+    const auto run = [&](size_t chunk) noexcept {
+        try {
+            apply(chunk_begin(chunk), chunk_begin(chunk + 1));
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+#else
+    const auto run = [&](size_t chunk) noexcept {
+        apply(chunk_begin(chunk), chunk_begin(chunk + 1));
+    };
+#endif
+
+    std::thread threads[MAX_PARALLEL_CHUNKS];
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        VECTOR_TRY {
+            threads[chunk] = std::thread(run, chunk);
+        } VECTOR_CATCH_ALL {
+            run(chunk);
+        }
+    }
+    run(0);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        if (threads[chunk].joinable()) {
+            threads[chunk].join();
+        }
+    }
+
+#if VECTOR_EXCEPTIONS
+    std::exception_ptr first_error;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (errors[chunk] && !first_error) {
+            first_error = errors[chunk];
+        }
+    }
+    if (first_error) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (!errors[chunk]) {
+                undo(chunk_begin(chunk), chunk_begin(chunk + 1));
+            }
+        }
+        std::rethrow_exception(first_error);
+    }
+#else
+    (void)undo;
+#endif
+}
+
+}  // namespace vector_detail
+
+// Непрерывный диапазон элементов, не владеющий памятью (упрощённый аналог std::span из C++20)
 template <typename T>
+class Span {
+public:
+    using iterator = T*;
+
+    constexpr Span() noexcept = default;
+
+    constexpr Span(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    constexpr T* begin() const noexcept {
+        return data_;
+    }
+
+    constexpr T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr T* Data() const noexcept {
+        return data_;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
 class Vector {
 public:
     using iterator = T*;
     using const_iterator = const T*;    
+    using allocator_type = typename RawMemory<T, Alloc>::allocator_type;
+
+private:
+    using AllocTraits = std::allocator_traits<allocator_type>;
+
+public:
 
     // Итераторы
-    iterator begin() noexcept { 
+    VECTOR_CONSTEXPR iterator begin() noexcept { 
         return data_.GetAddress(); 
     }
 
-    iterator end() noexcept { 
+    VECTOR_CONSTEXPR iterator end() noexcept { 
         return data_.GetAddress() + size_; 
     }
 
-    const_iterator begin() const noexcept { 
+    VECTOR_CONSTEXPR const_iterator begin() const noexcept { 
         return data_.GetAddress(); 
     }
 
-    const_iterator end() const noexcept { 
+    VECTOR_CONSTEXPR const_iterator end() const noexcept { 
         return data_.GetAddress() + size_; 
     }
 
-    const_iterator cbegin() const noexcept { 
+    VECTOR_CONSTEXPR const_iterator cbegin() const noexcept { 
         return begin(); 
     }
 
-    const_iterator cend() const noexcept { 
+    VECTOR_CONSTEXPR const_iterator cend() const noexcept { 
         return end(); 
     }
 
     // Конструкторы
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    VECTOR_CONSTEXPR explicit Vector(const allocator_type& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    VECTOR_CONSTEXPR explicit Vector(size_t size, const allocator_type& alloc = allocator_type())
+        : data_(size, alloc)
+        , size_(size)
+    {
+        vector_detail::UninitializedValueConstructN(begin(), size);
+    }
+
+    // Вектор из size элементов, инициализированных по умолчанию. Для тривиальных типов
+    // значения элементов не определены, пока их не перезапишут
+    VECTOR_CONSTEXPR Vector(size_t size, DefaultInitTag, const allocator_type& alloc = allocator_type())
+        : data_(size, alloc)
         , size_(size)
     {
-        std::uninitialized_value_construct_n(begin(), size);
+        vector_detail::UninitializedDefaultConstructN(begin(), size);
+    }
+
+    // Вектор из size элементов, инициализированных значением, которые конструируются
+    // параллельно (см. ParallelTag). При исключении разрушаются элементы всех частей
+    Vector(size_t size, ParallelTag tag, const allocator_type& alloc = allocator_type())
+        : data_(size, alloc)
+        , size_(size)
+    {
+        T* data = begin();
+        vector_detail::ParallelApply(
+            size, sizeof(T), tag,
+            [data](size_t first, size_t last) {
+                std::uninitialized_value_construct(data + first, data + last);
+            },
+            [data](size_t first, size_t last) noexcept {
+                std::destroy(data + first, data + last);
+            });
+    }
+
+    // Вектор из count копий value
+    VECTOR_CONSTEXPR Vector(size_t count, const T& value, const allocator_type& alloc = allocator_type())
+        : data_(count, alloc)
+        , size_(count)
+    {
+        vector_detail::UninitializedFillN(begin(), count, value);
+    }
+
+    // Конструктор из диапазона итераторов. Для forward-итераторов память выделяется
+    // один раз ровно под std::distance(first, last) элементов
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    VECTOR_CONSTEXPR Vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+        : Vector(alloc)
+    {
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            Reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        Append(first, last);
+    }
+
+    VECTOR_CONSTEXPR Vector(std::initializer_list<T> init, const allocator_type& alloc = allocator_type())
+        : Vector(init.begin(), init.end(), alloc)
+    {
     }
 
     // Конструктор копирования
-    Vector(const Vector& other)
-        : data_(other.size_)
+    VECTOR_CONSTEXPR Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {
+    }
+
+    // Конструктор копирования с явно заданным аллокатором
+    VECTOR_CONSTEXPR Vector(const Vector& other, const allocator_type& alloc)
+        : data_(other.size_, alloc)
+        , size_(other.size_)
+    {
+        vector_detail::UninitializedCopyN(other.begin(), size_, begin());
+    }
+
+    // Параллельное копирование (см. ParallelTag). Аллокатор выбирается как в конструкторе копирования
+    Vector(const Vector& other, ParallelTag tag)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
         , size_(other.size_)
     {
-        std::uninitialized_copy_n(other.begin(), size_, begin());
+        ParallelCopyConstruct(other.begin(), size_, begin(), tag);
     }
 
-    // Конструктор перемещения
-    Vector(Vector&& other) noexcept
+    // Конструктор перемещения. Состояние политики роста переходит вместе с буфером, как в Swap
+    VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
         : data_(std::move(other.data_))
-        , size_(other.size_) {
+        , size_(other.size_)
+        , growth_(std::move(other.growth_)) {
         other.size_ = 0;        
     }
 
-    // Деструктор
-    ~Vector() {
-        std::destroy_n(begin(), size_);
+    // Конструктор перемещения с явно заданным аллокатором.
+    // При неравных аллокаторах элементы перемещаются поштучно в новую память
+    VECTOR_CONSTEXPR Vector(Vector&& other, const allocator_type& alloc)
+        : data_(alloc) {
+        if (alloc == other.data_.GetAllocator()) {
+            data_.Swap(other.data_);
+            std::swap(size_, other.size_);
+        } else {
+            RawMemory<T, Alloc> new_data(other.size_, alloc);
+            vector_detail::UninitializedMoveN(other.begin(), other.size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = other.size_;
+        }
+    }
+
+    // Деструктор. Для тривиально разрушаемых типов остаётся только освобождение памяти
+    VECTOR_CONSTEXPR ~Vector() {
+        if (!vector_detail::IsConstantEvaluated()) {
+            VectorStats::RecordRelease(sizeof(T), data_.Capacity(), size_);
+        }
+        vector_detail::DestroyN(begin(), size_);
     }
 
-    // Оператор присваивания с базовой гарантией исключений
-    Vector& operator=(const Vector& rhs) {
-        if (this != &rhs) {
-            if (rhs.size_ > data_.Capacity()) {
-                // Строгая гарантия через copy-and-swap
-                Vector(rhs).Swap(*this);
-            } else {                
-                // Перезапись общих элементов
-                size_t i = 0;
-                const size_t common_size = std::min(size_, rhs.size_);
-                std::copy_n(rhs.begin(), common_size, begin());
-
-                // Обработка хвоста
-                if (size_ < rhs.size_) {
-                    std::uninitialized_copy_n(rhs.begin() + i, rhs.size_ - size_, begin() + i);
-                } else {
-                    std::destroy_n(begin() + rhs.size_, size_ - rhs.size_);
-                }
+    // Копирующее присваивание. Существующий буфер переиспользуется: живые элементы перезаписываются
+    // присваиванием, конструируется только недостающий хвост, тривиально копируемые элементы
+    // переносятся одним memcpy. Если вместимости не хватает и буфер не удалось расширить на месте,
+    // новый буфер выбирается политикой роста, элементы копируются в него до освобождения старого —
+    // строгая гарантия. Иначе гарантия базовая. Вектор сохраняет свой аллокатор
+    VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if (rhs.size_ > data_.Capacity()) {
+            const size_t new_capacity = growth_.NextCapacity(data_.Capacity(), rhs.size_, sizeof(T));
+            if (!TryExpandInPlace(new_capacity)) {
+                RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+                vector_detail::UninitializedCopyN(rhs.begin(), rhs.size_, new_data.GetAddress());
+                ReplaceData(new_data, rhs.size_);
+                return *this;
             }
         }
 
+        if (std::is_trivially_copyable_v<T> && !vector_detail::IsConstantEvaluated()) {
+            if (rhs.size_ != 0) {
+                std::memcpy(static_cast<void*>(begin()), static_cast<const void*>(rhs.begin()), rhs.size_ * sizeof(T));
+            }
+        } else if (size_ < rhs.size_) {
+            std::copy_n(rhs.begin(), size_, begin());
+            vector_detail::UninitializedCopyN(rhs.begin() + size_, rhs.size_ - size_, end());
+        } else {
+            std::copy_n(rhs.begin(), rhs.size_, begin());
+            vector_detail::DestroyN(begin() + rhs.size_, size_ - rhs.size_);
+        }
         size_ = rhs.size_;
         return *this;
     }
-    
-    // Оператор перемещения 
-    Vector& operator=(Vector&& rhs) noexcept {
+
+    // Оператор перемещения. Если аллокатор не распространяется при перемещении
+    // и аллокаторы не равны, элементы перемещаются поштучно в собственную память
+    VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
         if (this != &rhs) {
-            this->Swap(rhs);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                // Не Clear(): политика роста не должна считать присваивание очисткой
+                // и резервировать буфер, который тут же освобождается
+                vector_detail::DestroyN(begin(), size_);
+                size_ = 0;
+                if (!vector_detail::IsConstantEvaluated()) {
+                    VectorStats::RecordRelease(sizeof(T), data_.Capacity(), 0);
+                }
+                data_ = std::move(rhs.data_);
+                size_ = std::exchange(rhs.size_, 0);
+                growth_ = std::move(rhs.growth_);
+            } else if (data_.GetAllocator() == rhs.data_.GetAllocator()) {
+                this->Swap(rhs);
+            } else {
+                MoveAssignElements(rhs);
+            }
         }
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    VECTOR_CONSTEXPR Vector& operator=(std::initializer_list<T> init) {
+        Assign(init.begin(), init.end());
+        return *this;
+    }
+
+    VECTOR_CONSTEXPR void Swap(Vector& other) noexcept {
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
+        std::swap(growth_, other.growth_);
     }
 
     // Методы доступа
-    size_t Size() const noexcept {
+    VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    bool Empty() const noexcept {
+    VECTOR_CONSTEXPR allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    VECTOR_CONSTEXPR bool Empty() const noexcept {
         return size_ == 0;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
 
-    T& front() {
+    VECTOR_CONSTEXPR T& front() {
         assert(size_ > 0 && "Cannot call front() on empty vector");       
         return data_[0];
     }
 
-    const T& front() const {
+    VECTOR_CONSTEXPR const T& front() const {
         assert(size_ > 0 && "Cannot call front() on empty vector");
         return data_[0];
     }
 
-    T& back() {
+    VECTOR_CONSTEXPR T& back() {
         assert(size_ > 0 && "Cannot call back() on empty vector"); 
         return data_[size_ - 1];
     }
 
-    const T& back() const {
+    VECTOR_CONSTEXPR const T& back() const {
         assert(size_ > 0 && "Cannot call back() on empty vector");
         return data_[size_ - 1];
     }
 
-    T& At(size_t index) {
+    VECTOR_CONSTEXPR T& At(size_t index) {
         if (index >= size_) {
-            throw std::out_of_range("Vector::At: index out of range");
+            ReportVectorError(VectorError::OUT_OF_RANGE, "Vector::At: index out of range");
         }
         return data_[index];
     }
 
-    const T& At(size_t index) const {
+    VECTOR_CONSTEXPR const T& At(size_t index) const {
         if (index >= size_) {
-            throw std::out_of_range("Vector::At: index out of range");
+            ReportVectorError(VectorError::OUT_OF_RANGE, "Vector::At: index out of range");
         }
         return data_[index];
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity <= data_.Capacity()) {
+    VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+        const size_t old_capacity = data_.Capacity();
+        if (new_capacity <= old_capacity || TryExpandInPlace(new_capacity)) {
+            return;
+        }
+
+        if (data_.Reallocate(new_capacity)) {
+            RecordReallocation(old_capacity, new_capacity, true);
             return;
         }
 
-        RawMemory<T> new_data(new_capacity);
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
        
-        MoveOrCopyRange(begin(), end(), new_data.GetAddress());
+        RawMemory<T, Alloc>::RelocateN(begin(), size_, new_data.GetAddress());
 
-        std::destroy_n(begin(), size_);
+        RecordReallocation(old_capacity, new_capacity, false);
         data_.Swap(new_data);
     }
 
-    void Resize(size_t new_size) {
+    VECTOR_CONSTEXPR void Resize(size_t new_size) {
         if (new_size < size_) {            
-            std::destroy_n(begin() + new_size, size_ - new_size);
+            vector_detail::DestroyN(begin() + new_size, size_ - new_size);
         } else if (new_size > size_) {            
             if (new_size > data_.Capacity()) {
                 Reserve(new_size);
             }           
             
-            std::uninitialized_value_construct_n(end(), new_size - size_);
+            vector_detail::UninitializedValueConstructN(end(), new_size - size_);
         }
         size_ = new_size;
     }
 
-    // Очистка содержимого вектора без освобождения памяти
-    void Clear() noexcept {
-        std::destroy_n(begin(), size_);
-        size_ = 0;
-    }
+    // Аналог Resize, инициализирующий новые элементы по умолчанию. Для тривиальных типов новые
+    // элементы не инициализируются: страницы памяти впервые затронет тот, кто их заполнит
+    // (read(), recv(), декодер)
+    VECTOR_CONSTEXPR void ResizeDefaultInit(size_t new_size) {
+        if (new_size < size_) {
+            vector_detail::DestroyN(begin() + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            if (new_size > data_.Capacity()) {
+                Reserve(new_size);
+            }
 
-    //Методы размещения и удаления
-    template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
-        return *Emplace(end(), std::forward<Args>(args)...);
+            vector_detail::UninitializedDefaultConstructN(end(), new_size - size_);
+        }
+        size_ = new_size;
     }
 
-    void PushBack(const T& value) {
-        EmplaceBack(value);
+    // ResizeDefaultInit для тривиальных типов: явно выражает намерение оставить новые элементы
+    // неинициализированными
+    VECTOR_CONSTEXPR void ResizeUninitialized(size_t new_size) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "ResizeUninitialized requires a trivial element type");
+        ResizeDefaultInit(new_size);
     }
 
-    void PushBack(T&& value) {
-        EmplaceBack(std::move(value));
-    }
+    // Очистка содержимого вектора без освобождения памяти
+    VECTOR_CONSTEXPR void Clear() noexcept {
+        const size_t old_size = size_;
+        vector_detail::DestroyN(begin(), size_);
+        size_ = 0;
+        if constexpr (HasOnClear<Growth>::value) {
+            TrimAfterClear(old_size);
+        }
+    }
 
-    void PopBack() noexcept {
+    // Clear, разрушающий элементы параллельно (см. ParallelTag)
+    void ParallelClear(ParallelTag tag = parallel) noexcept {
+        const size_t old_size = size_;
+        ParallelDestroy(begin(), size_, tag);
+        size_ = 0;
+        if constexpr (HasOnClear<Growth>::value) {
+            TrimAfterClear(old_size);
+        }
+    }
+
+    // Копирующее присваивание, выполняемое параллельно (см. ParallelTag), с теми же гарантиями,
+    // что и operator=: при нехватке вместимости — строгая, иначе базовая
+    void ParallelCopyFrom(const Vector& rhs, ParallelTag tag = parallel) {
+        if (this == &rhs) {
+            return;
+        }
+        if (rhs.size_ > data_.Capacity()) {
+            RawMemory<T, Alloc> new_data(rhs.size_, data_.GetAllocator());
+            ParallelCopyConstruct(rhs.begin(), rhs.size_, new_data.GetAddress(), tag);
+            ParallelDestroy(begin(), size_, tag);
+            VectorStats::RecordRelease(sizeof(T), data_.Capacity(), size_);
+            data_.Swap(new_data);
+            size_ = rhs.size_;
+            return;
+        }
+
+        const size_t common_size = std::min(size_, rhs.size_);
+        const T* from = rhs.begin();
+        T* to = begin();
+        vector_detail::ParallelApply(
+            common_size, sizeof(T), tag,
+            [from, to](size_t first, size_t last) {
+                std::copy(from + first, from + last, to + first);
+            },
+            [](size_t /*first*/, size_t /*last*/) noexcept {});
+        if (size_ < rhs.size_) {
+            ParallelCopyConstruct(rhs.begin() + size_, rhs.size_ - size_, end(), tag);
+        } else {
+            ParallelDestroy(begin() + rhs.size_, size_ - rhs.size_, tag);
+        }
+        size_ = rhs.size_;
+    }
+
+    // Уменьшает вместимость до размера. Как и Reserve, при исключении оставляет вектор
+    // в прежнем состоянии
+    VECTOR_CONSTEXPR void ShrinkToFit() {
+        if (size_ == data_.Capacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            ReleaseMemory();
+            return;
+        }
+        const size_t old_capacity = data_.Capacity();
+        if (data_.Reallocate(size_)) {
+            RecordReallocation(old_capacity, size_, true);
+            return;
+        }
+
+        RawMemory<T, Alloc> new_data(size_, data_.GetAllocator());
+        RawMemory<T, Alloc>::RelocateN(begin(), size_, new_data.GetAddress());
+        RecordReallocation(old_capacity, size_, false);
+        data_.Swap(new_data);
+    }
+
+    // Разрушает элементы и освобождает память: вместимость становится нулевой
+    VECTOR_CONSTEXPR void ReleaseMemory() noexcept {
+        if (!vector_detail::IsConstantEvaluated()) {
+            VectorStats::RecordRelease(sizeof(T), data_.Capacity(), size_);
+        }
+        vector_detail::DestroyN(begin(), size_);
+        size_ = 0;
+        RawMemory<T, Alloc>(data_.GetAllocator()).Swap(data_);
+    }
+
+    // Разрушает элементы, освобождает память и принимает во владение буфер data вместимостью
+    // capacity, первые size элементов которого уже сконструированы. Копирования нет: вектор
+    // работает прямо в буфере и освободит его через deleter (см. RawMemory::Adopt), а при росте
+    // сверх capacity перенесёт элементы в память своего аллокатора
+    void Adopt(T* data, size_t size, size_t capacity, BufferDeleter<T> deleter = {}) noexcept {
+        assert(size <= capacity && "Adopt: size exceeds capacity");
+        ReleaseMemory();
+        data_.Adopt(data, capacity, deleter);
+        size_ = size;
+    }
+
+    // Отдаёт буфер вместе с элементами вызывающему без копирования; вектор становится пустым
+    // с нулевой вместимостью (см. RawMemory::Release)
+    ReleasedBuffer<T> Release() noexcept {
+        ReleasedBuffer<T> result = data_.Release();
+        result.size = std::exchange(size_, 0);
+        return result;
+    }
+
+    //Методы размещения и удаления
+
+    // Вставка в конец без общего пути Emplace: при свободной вместимости — сравнение, размещение
+    // элемента и инкремент размера, реаллокация вынесена в отдельную функцию
+    template <typename... Args>
+    VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args) {
+        if (size_ < data_.Capacity()) {
+            T* element = vector_detail::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+            ++size_;
+            return *element;
+        }
+        return EmplaceBackWithReallocation(std::forward<Args>(args)...);
+    }
+
+    VECTOR_CONSTEXPR void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    VECTOR_CONSTEXPR void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Транзакция добавления в конец, которую возвращает GrowBy. Слоты за концом вектора уже
+    // зарезервированы; Emplace конструирует их по порядку без проверок вместимости, Commit
+    // переносит сконструированные элементы в размер вектора. Если Commit не вызван (в том числе
+    // из-за исключения), деструктор разрушает сконструированные элементы и вектор остаётся прежним
+    class AppendGuard {
+    public:
+        AppendGuard(const AppendGuard&) = delete;
+        AppendGuard& operator=(const AppendGuard&) = delete;
+
+        ~AppendGuard() {
+            std::destroy_n(slots_.Data(), constructed_);
+        }
+
+        // Неинициализированная память под добавляемые элементы
+        Span<T> Slots() const noexcept {
+            return slots_;
+        }
+
+        size_t Constructed() const noexcept {
+            return constructed_;
+        }
+
+        template <typename... Args>
+        T& Emplace(Args&&... args) {
+            assert(constructed_ < slots_.Size() && "AppendGuard: all slots are constructed");
+            T* element = new (slots_.Data() + constructed_) T(std::forward<Args>(args)...);
+            ++constructed_;
+            return *element;
+        }
+
+        // Добавляет сконструированные элементы к вектору; несконструированные слоты остаются
+        // свободной вместимостью
+        void Commit() noexcept {
+            vector_.size_ += constructed_;
+            slots_ = Span<T>(slots_.Data() + constructed_, slots_.Size() - constructed_);
+            constructed_ = 0;
+        }
+
+    private:
+        friend class Vector;
+
+        AppendGuard(Vector& vector, Span<T> slots) noexcept
+            : vector_(vector)
+            , slots_(slots) {
+        }
+
+        Vector& vector_;
+        Span<T> slots_;
+        size_t constructed_ = 0;
+    };
+
+    // Резервирует место под count элементов за концом (при нехватке вместимости — по политике
+    // роста, одной реаллокацией) и возвращает транзакцию их добавления. Пока транзакция жива,
+    // вектор нельзя изменять иначе, чем через неё
+    AppendGuard GrowBy(size_t count) {
+        ReserveForAppend(count);
+        return AppendGuard(*this, Span<T>(end(), count));
+    }
+
+    // Увеличивает размер на count неинициализированных элементов тривиального типа и возвращает
+    // их диапазон: одна проверка вместимости и одно обновление размера на весь блок
+    Span<T> AppendUninitialized(size_t count) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "AppendUninitialized requires a trivial element type");
+        ReserveForAppend(count);
+        T* first = end();
+        size_ += count;
+        return Span<T>(first, count);
+    }
+
+    VECTOR_CONSTEXPR void PopBack() noexcept {
         assert(size_ > 0 && "PopBack() called on empty vector");        
         --size_;
-        std::destroy_at(data_ + size_);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy_at(data_ + size_);
+        }
     }
 
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args) {
+    VECTOR_CONSTEXPR iterator Emplace(const_iterator pos, Args&&... args) {
         assert(pos >= begin() && pos <= end() && "Invalid position for Emplace");
         size_t index = pos - begin();
 
@@ -321,100 +1407,882 @@ public:
         return begin() + index;
     }
 
-    iterator Insert(const_iterator pos, const T& value) {
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, const T& value) {
         return Emplace(pos, value);
     }
 
-    iterator Insert(const_iterator pos, T&& value) {
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, T&& value) {
         return Emplace(pos, std::move(value));
     }
 
+    // Вставка count копий value. Выполняет не больше одной реаллокации и сдвигает хвост один раз,
+    // для тривиально копируемых типов — одним memmove. Возвращает итератор на первый вставленный элемент
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, size_t count, const T& value) {
+        assert(pos >= begin() && pos <= end() && "Invalid position for Insert");
+        const size_t index = pos - begin();
+        if (count == 0) {
+            return begin() + index;
+        }
 
-    iterator Erase(const_iterator pos) {
+        if (size_ + count > Capacity()) {
+            const size_t new_capacity = growth_.NextCapacity(Capacity(), size_ + count, sizeof(T));
+            if (!TryExpandInPlace(new_capacity)) {
+                RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+                vector_detail::UninitializedFillN(new_data + index, count, value);
+                RelocateAroundGap(new_data, index, count);
+                size_ += count;
+                return begin() + index;
+            }
+        }
+
+        // value может ссылаться на элемент вектора, который будет сдвинут
+        const T copy(value);
+        T* position = begin() + index;
+        T* old_end = end();
+        const size_t elems_after = size_ - index;
+        if (std::is_trivially_copyable_v<T> && !vector_detail::IsConstantEvaluated()) {
+            // Копирование не выбрасывает исключений: хвост сдвигается побайтово, место заполняется
+            ShiftTailBitwise(index, count);
+            std::uninitialized_fill_n(position, count, copy);
+        } else if (count <= elems_after) {
+            vector_detail::UninitializedMoveN(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(position, old_end - count, old_end);
+            std::fill_n(position, count, copy);
+        } else {
+            vector_detail::UninitializedFillN(old_end, count - elems_after, copy);
+            size_ += count - elems_after;
+            vector_detail::UninitializedMoveN(position, elems_after, end());
+            size_ += elems_after;
+            std::fill(position, old_end, copy);
+        }
+        return begin() + index;
+    }
+
+    // Вставка диапазона [first, last). Для forward-итераторов итоговый размер вычисляется заранее:
+    // не больше одной реаллокации и единственный сдвиг хвоста. Элементы input-итераторов
+    // добавляются в конец и затем поворачиваются на место.
+    // Диапазон не должен указывать на элементы этого вектора, если реаллокация не требуется
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        assert(pos >= begin() && pos <= end() && "Invalid position for Insert");
+        const size_t index = pos - begin();
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            InsertRange(index, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + index, begin() + old_size, end());
+        }
+        return begin() + index;
+    }
+
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, std::initializer_list<T> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    // Добавление диапазона в конец вектора
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    VECTOR_CONSTEXPR void Append(InputIt first, InputIt last) {
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            InsertRange(size_, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    VECTOR_CONSTEXPR void Append(std::initializer_list<T> init) {
+        Append(init.begin(), init.end());
+    }
+
+    // Замена содержимого диапазоном [first, last). Существующие элементы переиспользуются
+    // присваиванием, память выделяется только если новый размер превышает вместимость.
+    // Новый буфер вмещает ровно count элементов; состояние политики роста сохраняется
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > Capacity()) {
+                RawMemory<T, Alloc> new_data(count, data_.GetAllocator());
+                vector_detail::UninitializedCopyN(first, count, new_data.GetAddress());
+                ReplaceData(new_data, count);
+            } else if (count <= size_) {
+                iterator new_end = std::copy(first, last, begin());
+                std::destroy(new_end, end());
+                size_ = count;
+            } else {
+                InputIt mid = std::next(first, size_);
+                std::copy(first, mid, begin());
+                vector_detail::UninitializedCopyN(mid, count - size_, end());
+                size_ = count;
+            }
+        } else {
+            Clear();
+            Append(first, last);
+        }
+    }
+
+    VECTOR_CONSTEXPR void Assign(size_t count, const T& value) {
+        if (count > Capacity()) {
+            RawMemory<T, Alloc> new_data(count, data_.GetAllocator());
+            vector_detail::UninitializedFillN(new_data.GetAddress(), count, value);
+            ReplaceData(new_data, count);
+        } else if (count <= size_) {
+            std::fill_n(begin(), count, value);
+            std::destroy(begin() + count, end());
+            size_ = count;
+        } else {
+            std::fill(begin(), end(), value);
+            vector_detail::UninitializedFillN(end(), count - size_, value);
+            size_ = count;
+        }
+    }
+
+    VECTOR_CONSTEXPR void Assign(std::initializer_list<T> init) {
+        Assign(init.begin(), init.end());
+    }
+
+
+    VECTOR_CONSTEXPR iterator Erase(const_iterator pos) {
         assert(pos >= begin() && pos < end() && "Invalid position for Erase");        
-        
-        iterator mutable_pos = begin() + (pos - begin());        
-        std::destroy_at(mutable_pos);
-        
-        // Сдвигаем последующие элементы влево на одну поз.
-        if (mutable_pos + 1 != end()) {
-            std::move(mutable_pos + 1, end(), mutable_pos);
-        }     
-       
-        --size_;
-                
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаление диапазона [first, last): хвост сдвигается один раз.
+    // Для тривиально перемещаемых типов удаляемые элементы разрушаются, а хвост переносится memmove
+    VECTOR_CONSTEXPR iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= begin() && first <= last && last <= end() && "Invalid range for Erase");
+
+        iterator mutable_first = begin() + (first - begin());
+        iterator mutable_last = begin() + (last - begin());
+        if (mutable_first == mutable_last) {
+            return mutable_first;
+        }
+
+        if (IsTriviallyRelocatableV<T> && !vector_detail::IsConstantEvaluated()) {
+            vector_detail::DestroyN(mutable_first, mutable_last - mutable_first);
+            std::memmove(static_cast<void*>(mutable_first), static_cast<const void*>(mutable_last),
+                         (end() - mutable_last) * sizeof(T));
+        } else {
+            // Сдвигаем последующие элементы влево и разрушаем освободившийся конец
+            iterator new_end = std::move(mutable_last, end(), mutable_first);
+            vector_detail::DestroyN(new_end, end() - new_end);
+        }
+        size_ -= mutable_last - mutable_first;
+
+        return mutable_first;
+    }
+
+    // Удаляет все элементы, для которых pred возвращает true, за один проход с сохранением
+    // порядка остальных. Возвращает число удалённых элементов. Для тривиально перемещаемых типов
+    // сохраняемые элементы переносятся memmove непрерывными участками
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        const size_t old_size = size_;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            T* out = begin();
+            T* run_begin = begin();
+            T* const last = end();
+            // Участок [run_begin, it) сохраняется и ещё не перенесён на место out
+            const auto flush = [&out](T* from, T* to) {
+                if (out != from) {
+                    std::memmove(static_cast<void*>(out), static_cast<const void*>(from), (to - from) * sizeof(T));
+                }
+                out += to - from;
+            };
+            VECTOR_TRY {
+                for (T* it = run_begin; it != last; ++it) {
+                    if (pred(*it)) {
+                        flush(run_begin, it);
+                        std::destroy_at(it);
+                        run_begin = it + 1;
+                    }
+                }
+            } VECTOR_CATCH_ALL {
+                // Непроверенные элементы сохраняются: вектор остаётся без «дыр»
+                flush(run_begin, last);
+                size_ = out - begin();
+                VECTOR_RETHROW;
+            }
+            flush(run_begin, last);
+            size_ = out - begin();
+        } else {
+            iterator new_end = std::remove_if(begin(), end(), pred);
+            std::destroy(new_end, end());
+            size_ = new_end - begin();
+        }
+        return old_size - size_;
+    }
+
+    // Удаление без сохранения порядка: на место pos переносится последний элемент.
+    // Выполняется за O(1). Возвращает итератор на элемент, занявший позицию pos
+    VECTOR_CONSTEXPR iterator UnorderedErase(const_iterator pos) {
+        assert(pos >= begin() && pos < end() && "Invalid position for UnorderedErase");
+
+        iterator mutable_pos = begin() + (pos - begin());
+        iterator last = end() - 1;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            if (!vector_detail::IsConstantEvaluated()) {
+                std::destroy_at(mutable_pos);
+                if (mutable_pos != last) {
+                    std::memcpy(static_cast<void*>(mutable_pos), static_cast<const void*>(last), sizeof(T));
+                }
+                --size_;
+                return mutable_pos;
+            }
+        }
+        if (mutable_pos != last) {
+            *mutable_pos = std::move(*last);
+        }
+        PopBack();
         return mutable_pos;
     }
 
+    // Алгоритмы над элементами (файл simd_kernels.h). Для 32-битных целых и float используются
+    // векторные ядра AVX2, если их поддерживает процессор, для остальных типов — обычные циклы
+    iterator Find(const T& value) {
+        return const_cast<iterator>(std::as_const(*this).Find(value));
+    }
+
+    const_iterator Find(const T& value) const {
+        return vector_simd::Find(cbegin(), cend(), value);
+    }
+
+    size_t Count(const T& value) const {
+        return vector_simd::Count(cbegin(), cend(), value);
+    }
+
+    bool Contains(const T& value) const {
+        return Find(value) != cend();
+    }
+
+    // Сумма элементов, начиная с T{}. Сумма float вычисляется в другом порядке, чем у std::accumulate
+    T Sum() const {
+        return vector_simd::Sum(cbegin(), cend());
+    }
+
+    // Наименьший и наибольший элементы непустого вектора
+    std::pair<T, T> MinMax() const {
+        assert(size_ > 0 && "Cannot call MinMax() on empty vector");
+        return vector_simd::MinMax(cbegin(), cend());
+    }
+
+    // Присваивает value всем элементам
+    void Fill(const T& value) {
+        vector_simd::Fill(begin(), end(), value);
+    }
+
+    // Присваивает элементам значения value, value + 1, ...
+    void Iota(T value) {
+        vector_simd::Iota(begin(), end(), std::move(value));
+    }
+
 private:  
+    // Разрушает элементы и делает буфером new_data с new_size уже построенными элементами.
+    // Прежний буфер освобождается вместе с new_data
+    VECTOR_CONSTEXPR void ReplaceData(RawMemory<T, Alloc>& new_data, size_t new_size) noexcept {
+        vector_detail::DestroyN(begin(), size_);
+        if (!vector_detail::IsConstantEvaluated()) {
+            VectorStats::RecordRelease(sizeof(T), data_.Capacity(), size_);
+        }
+        data_.Swap(new_data);
+        size_ = new_size;
+    }
+
+    // Сообщает VectorStats о смене буфера с size_ элементами. Первое выделение памяти
+    // реаллокацией не считается. Без VECTOR_ENABLE_STATS ничего не делает
+    VECTOR_CONSTEXPR void RecordReallocation(size_t old_capacity, size_t new_capacity, bool in_place) const noexcept {
+        if (old_capacity != 0 && !vector_detail::IsConstantEvaluated()) {
+            VectorStats::RecordReallocation({sizeof(T), old_capacity, new_capacity, size_, in_place});
+        }
+    }
+
+    // Параллельно конструирует в to копии count элементов from. При исключении to остаётся пустым
+    static void ParallelCopyConstruct(const T* from, size_t count, T* to, ParallelTag tag) {
+        vector_detail::ParallelApply(
+            count, sizeof(T), tag,
+            [from, to](size_t first, size_t last) {
+                std::uninitialized_copy(from + first, from + last, to + first);
+            },
+            [to](size_t first, size_t last) noexcept {
+                std::destroy(to + first, to + last);
+            });
+    }
+
+    static void ParallelDestroy(T* data, size_t count, ParallelTag tag) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            vector_detail::ParallelApply(
+                count, sizeof(T), tag,
+                [data](size_t first, size_t last) noexcept {
+                    std::destroy(data + first, data + last);
+                },
+                [](size_t /*first*/, size_t /*last*/) noexcept {});
+        }
+    }
+
+    // Расширяет буфер на месте (см. RawMemory::TryExpand). Без try_expand у аллокатора всегда false
+    VECTOR_CONSTEXPR bool TryExpandInPlace(size_t new_capacity) noexcept {
+        const size_t old_capacity = data_.Capacity();
+        if (data_.TryExpand(new_capacity)) {
+            RecordReallocation(old_capacity, new_capacity, true);
+            return true;
+        }
+        return false;
+    }
+
     // Выбираем перемещение, если оно noexcept, иначе копирование.
-    void MoveOrCopyRange(T* from_begin, T* from_end, T* to_begin) {
-        size_t count = from_end - from_begin;
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(from_begin, count, to_begin);
+    VECTOR_CONSTEXPR void MoveOrCopyRange(T* from_begin, T* from_end, T* to_begin) {
+        RawMemory<T, Alloc>::MoveOrCopyN(from_begin, from_end - from_begin, to_begin);
+    }
+
+    // Применяет к пустому вектору вместимость, запрошенную политикой роста (см. HasOnClear)
+    void TrimAfterClear(size_t size_before_clear) noexcept {
+        const size_t target = growth_.OnClear(size_before_clear, data_.Capacity());
+        if (target >= data_.Capacity()) {
+            return;
+        }
+        VectorStats::RecordRelease(sizeof(T), data_.Capacity(), 0);
+        RawMemory<T, Alloc>(data_.GetAllocator()).Swap(data_);
+        VECTOR_TRY {
+            Reserve(target);
+        } VECTOR_CATCH_ALL {
+            // Нехватка памяти при уменьшении не ошибка: вектор просто остаётся без буфера
+        }
+    }
+
+    // Поэлементное перемещение из вектора с неравным аллокатором
+    void MoveAssignElements(Vector& rhs) {
+        if (rhs.size_ > data_.Capacity()) {
+            RawMemory<T, Alloc> new_data(rhs.size_, data_.GetAllocator());
+            std::uninitialized_move_n(rhs.begin(), rhs.size_, new_data.GetAddress());
+            VectorStats::RecordRelease(sizeof(T), data_.Capacity(), size_);
+            std::destroy_n(begin(), size_);
+            data_.Swap(new_data);
         } else {
-            std::uninitialized_copy_n(from_begin, count, to_begin);
+            const size_t common_size = std::min(size_, rhs.size_);
+            std::move(rhs.begin(), rhs.begin() + common_size, begin());
+            if (size_ < rhs.size_) {
+                std::uninitialized_move_n(rhs.begin() + size_, rhs.size_ - size_, end());
+            } else {
+                std::destroy_n(begin() + rhs.size_, size_ - rhs.size_);
+            }
         }
+        size_ = rhs.size_;
+        rhs.Clear();
     }
 
     template <typename... Args>
-    void EmplaceWithReallocation(size_t index, Args&&... args) {
-        const size_t new_capacity = Capacity() == 0 ? 1 : Capacity() * 2;
-        RawMemory<T> new_data(new_capacity);
+    VECTOR_NOINLINE VECTOR_CONSTEXPR T& EmplaceBackWithReallocation(Args&&... args) {
+        EmplaceWithReallocation(size_, std::forward<Args>(args)...);
+        ++size_;
+        return data_[size_ - 1];
+    }
+
+    // Вместимость под count новых элементов за концом по политике роста
+    VECTOR_CONSTEXPR void ReserveForAppend(size_t count) {
+        if (count > data_.Capacity() - size_) {
+            if (count > std::numeric_limits<size_t>::max() - size_) {
+                ReportVectorError(VectorError::LENGTH_ERROR, "Vector: appended size overflows size_t");
+            }
+            Reserve(growth_.NextCapacity(data_.Capacity(), size_ + count, sizeof(T)));
+        }
+    }
+
+    template <typename... Args>
+    VECTOR_CONSTEXPR void EmplaceWithReallocation(size_t index, Args&&... args) {
+        const size_t new_capacity = growth_.NextCapacity(Capacity(), size_ + 1, sizeof(T));
+        if (TryExpandInPlace(new_capacity)) {
+            // Элементы остались на месте, поэтому аргументы, ссылающиеся на них, по-прежнему валидны
+            EmplaceWithoutReallocation(index, std::forward<Args>(args)...);
+            return;
+        }
+        if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE) {
+            EmplaceWithBlockReallocation(index, new_capacity, std::forward<Args>(args)...);
+            return;
+        }
+
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
 
         // Конструируем новый элемент на новом месте
-        T* new_element = new (new_data + index) T(std::forward<Args>(args)...);
+        vector_detail::ConstructAt(new_data + index, std::forward<Args>(args)...);
 
-        // Перемещаем/копируем  элементы ДО `index` с диагностикой
-        try {
-            MoveOrCopyRange(begin(), begin() + index, new_data.GetAddress());
-        } catch (const std::exception& e) {
-            std::destroy_at(new_element);
-            throw std::runtime_error("Failed to move elements BEFORE insertion: " + std::string(e.what()));
-        } catch (...) {
-            std::destroy_at(new_element);
-            throw std::runtime_error("Unknown error while moving elements BEFORE insertion");
+        RelocateAroundGap(new_data, index, 1);
+    }
+
+    // Переносит элементы в new_data так, что между [0, index) и [index, size_) остаются gap
+    // уже сконструированных по индексу index элементов, и делает new_data буфером вектора.
+    // При исключении элементы промежутка разрушаются, исключение переданного элемента
+    // распространяется без изменений, а вектор остаётся в прежнем состоянии
+    VECTOR_CONSTEXPR void RelocateAroundGap(RawMemory<T, Alloc>& new_data, size_t index, size_t gap) {
+        if constexpr (IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>) {
+            // Перенос не выбрасывает исключений: обработчики не нужны
+            RawMemory<T, Alloc>::RelocateN(begin(), index, new_data.GetAddress());
+            RawMemory<T, Alloc>::RelocateN(begin() + index, size_ - index, new_data.GetAddress() + index + gap);
+        } else {
+            VECTOR_TRY {
+                MoveOrCopyRange(begin(), begin() + index, new_data.GetAddress());
+            } VECTOR_CATCH_ALL {
+                vector_detail::DestroyN(new_data.GetAddress() + index, gap);
+                VECTOR_RETHROW;
+            }
+            VECTOR_TRY {
+                MoveOrCopyRange(begin() + index, end(), new_data.GetAddress() + index + gap);
+            } VECTOR_CATCH_ALL {
+                vector_detail::DestroyN(new_data.GetAddress(), index + gap);
+                VECTOR_RETHROW;
+            }
+            vector_detail::DestroyN(begin(), size_);
         }
+        RecordReallocation(data_.Capacity(), new_data.Capacity(), false);
+        data_.Swap(new_data);
+    }
 
-        // Перемещаем/копируем элементы ПОСЛЕ `index` с диагностикой
-        try {
-            MoveOrCopyRange(begin() + index, end(), new_data.GetAddress() + index + 1);
-        } catch (const std::exception& e) {
-            std::destroy_n(new_data.GetAddress(), index + 1);
-            throw std::runtime_error("Failed to move elements AFTER insertion: " + std::string(e.what()));
-        } catch (...) {
-            std::destroy_n(new_data.GetAddress(), index + 1);
-            throw std::runtime_error("Unknown error while moving elements AFTER insertion");
+    // Вставка n элементов из forward-диапазона, начинающегося с first
+    template <typename ForwardIt>
+    VECTOR_CONSTEXPR void InsertRange(size_t index, ForwardIt first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+
+        if (size_ + count > Capacity()) {
+            const size_t new_capacity = growth_.NextCapacity(Capacity(), size_ + count, sizeof(T));
+            if (!TryExpandInPlace(new_capacity)) {
+                RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+                // Диапазон копируется до переноса: он может указывать на элементы этого вектора
+                vector_detail::UninitializedCopyN(first, count, new_data + index);
+                RelocateAroundGap(new_data, index, count);
+                size_ += count;
+                return;
+            }
+        }
+
+        if (index == size_) {
+            // Добавление в конец (Append): сдвигать нечего
+            vector_detail::UninitializedCopyN(first, count, end());
+            size_ += count;
+            return;
+        }
+
+        T* position = begin() + index;
+        T* old_end = end();
+        const size_t elems_after = size_ - index;
+        if (std::is_trivially_copyable_v<T> &&
+            std::is_nothrow_constructible_v<T, typename std::iterator_traits<ForwardIt>::reference> &&
+            !vector_detail::IsConstantEvaluated()) {
+            // Конструирование не выбрасывает исключений: хвост сдвигается одним memmove
+            ShiftTailBitwise(index, count);
+            std::uninitialized_copy_n(first, count, position);
+        } else if (count <= elems_after) {
+            // Последние count элементов переезжают в неинициализированную память,
+            // остальные сдвигаются присваиванием, освободившееся место перезаписывается
+            vector_detail::UninitializedMoveN(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(position, old_end - count, old_end);
+            std::copy_n(first, count, position);
+        } else {
+            // Часть диапазона сразу конструируется за концом, хвост переезжает за неё
+            ForwardIt mid = std::next(first, elems_after);
+            vector_detail::UninitializedCopyN(mid, count - elems_after, old_end);
+            size_ += count - elems_after;
+            vector_detail::UninitializedMoveN(position, elems_after, end());
+            size_ += elems_after;
+            std::copy(first, mid, position);
         }
-        
-        std::destroy_n(begin(), size_);
-        data_.Swap(new_data);        
     }
 
+    // Сдвигает хвост [index, size_) на count позиций вправо побайтово и включает освободившиеся
+    // позиции в размер: вызывающий сразу конструирует в них элементы, не выбрасывая исключений.
+    // Только для тривиально копируемых типов во время выполнения
+    void ShiftTailBitwise(size_t index, size_t count) noexcept {
+        std::memmove(static_cast<void*>(data_ + (index + count)), static_cast<const void*>(data_ + index),
+                     (size_ - index) * sizeof(T));
+        size_ += count;
+    }
+
+    // Реаллокация средствами аллокатора (см. RawMemory::Reallocate). Новый элемент сначала
+    // конструируется во временном буфере: аргументы могут ссылаться на элементы вектора,
+    // которые после смены блока окажутся по другому адресу. Затем элемент переносится побайтово
     template <typename... Args>
-    void EmplaceWithoutReallocation(size_t index, Args&&... args) {
+    void EmplaceWithBlockReallocation(size_t index, size_t new_capacity, Args&&... args) {
+        alignas(T) std::byte element[sizeof(T)];
+        new (element) T(std::forward<Args>(args)...);
+
+        const size_t old_capacity = data_.Capacity();
+        if (data_.Reallocate(new_capacity)) {
+            RecordReallocation(old_capacity, new_capacity, true);
+            std::memmove(static_cast<void*>(data_ + index + 1), static_cast<const void*>(data_ + index),
+                         (size_ - index) * sizeof(T));
+        } else {
+            VECTOR_TRY {
+                RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+                RawMemory<T, Alloc>::RelocateN(begin(), index, new_data.GetAddress());
+                RawMemory<T, Alloc>::RelocateN(begin() + index, size_ - index, new_data.GetAddress() + index + 1);
+                RecordReallocation(old_capacity, new_capacity, false);
+                data_.Swap(new_data);
+            } VECTOR_CATCH_ALL {
+                std::destroy_at(reinterpret_cast<T*>(element));
+                VECTOR_RETHROW;
+            }
+        }
+        std::memcpy(static_cast<void*>(data_ + index), element, sizeof(T));
+    }
+
+    template <typename... Args>
+    VECTOR_CONSTEXPR void EmplaceWithoutReallocation(size_t index, Args&&... args) {
         if (index == size_) {
             // Вставка в конец
-            new (data_ + size_) T(std::forward<Args>(args)...);
+            vector_detail::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+        } else if (std::is_trivially_copyable_v<T> && !vector_detail::IsConstantEvaluated()) {
+            // Временный элемент нужен: аргументы могут ссылаться на сдвигаемые элементы
+            T temp(std::forward<Args>(args)...);
+            std::memmove(static_cast<void*>(data_ + (index + 1)), static_cast<const void*>(data_ + index),
+                         (size_ - index) * sizeof(T));
+            std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(&temp), sizeof(T));
         } else {
             // Вставка в середину с временным элементом
             // Создаем временный элемент
             T temp(std::forward<Args>(args)...);
             // Сдвигаем хвост с конца на одну позицию вперёд
-            new (data_ + size_) T(std::move(data_[size_ - 1]));
+            vector_detail::ConstructAt(data_ + size_, std::move(data_[size_ - 1]));
 
-            try {
-                // Сдвигаем на одну поз. вправо остальные элементы с конца до index
+            if constexpr (std::is_nothrow_move_assignable_v<T>) {
                 std::move_backward(begin() + index, end() - 1, end());
-                // Заменяем элемент на позиции index
                 data_[index] = std::move(temp);
-            } catch (...) {
-                std::destroy_at(data_ + size_);
-                throw;
+            } else {
+                VECTOR_TRY {
+                    // Сдвигаем на одну поз. вправо остальные элементы с конца до index
+                    std::move_backward(begin() + index, end() - 1, end());
+                    // Заменяем элемент на позиции index
+                    data_[index] = std::move(temp);
+                } VECTOR_CATCH_ALL {
+                    std::destroy_at(data_ + size_);
+                    VECTOR_RETHROW;
+                }
             }
         }
     }
 
-    RawMemory<T> data_;
+    RawMemory<T, Alloc> data_;
+    size_t size_ = 0;
+    [[no_unique_address]] Growth growth_;
+};
+
+// Сравнение векторов. Равенство для целых, перечислений и указателей проверяется одним memcmp
+// (во время компиляции — поэлементно)
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator==(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    if (vector_detail::IsConstantEvaluated()) {
+        return lhs.Size() == rhs.Size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    return lhs.Size() == rhs.Size() && vector_simd::Equal(lhs.begin(), rhs.begin(), lhs.Size());
+}
+
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator!=(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    return !(lhs == rhs);
+}
+
+// Лексикографическое сравнение
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator<(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator>(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator<=(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Alloc, typename Growth>
+VECTOR_CONSTEXPR bool operator>=(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    return !(lhs < rhs);
+}
+
+// Контейнер «структура массивов»: каждое поле строки хранится в собственном столбце RawMemory,
+// поэтому проход по одному-двум полям читает только их столбцы и не тратит кеш-линии на остальные.
+// Строка добавляется EmplaceBack(a, b, c), столбец для векторизованного прохода доступен как
+// Column<I>(), а operator[] возвращает прокси std::tuple<Fields&...> (работает со structured
+// bindings и присваиванием кортежа). Все столбцы имеют общую вместимость и растут вместе:
+// реаллокация переносит каждый столбец как Vector (memcpy для тривиально перемещаемых полей)
+// и даёт строгую гарантию безопасности исключений для всего контейнера
+template <typename... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    using Indices = std::index_sequence_for<Fields...>;
+
+public:
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using value_type = std::tuple<Fields...>;
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_t ROW_SIZE = (sizeof(Fields) + ...);
+
+    SoAVector() = default;
+
+    // Конструкторы, заполняющие строки, делегируют конструктору по умолчанию: при исключении
+    // деструктор разрушит уже построенные строки
+    explicit SoAVector(size_t size)
+        : SoAVector() {
+        Resize(size);
+    }
+
+    SoAVector(const SoAVector& other)
+        : SoAVector() {
+        Reserve(other.size_);
+        CopyRows(other, Indices{});
+    }
+
+    SoAVector(SoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~SoAVector() {
+        Clear();
+    }
+
+    // Строгая гарантия через copy-and-swap
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            SoAVector(std::move(rhs)).Swap(*this);
+        }
+        return *this;
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        SwapColumns(other, Indices{});
+        std::swap(size_, other.size_);
+    }
+
+    // Методы доступа
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    reference At(size_t index) {
+        if (index >= size_) {
+            ReportVectorError(VectorError::OUT_OF_RANGE, "SoAVector::At: index out of range");
+        }
+        return Row(index, Indices{});
+    }
+
+    const_reference At(size_t index) const {
+        return const_cast<SoAVector&>(*this).At(index);
+    }
+
+    // Столбец поля I: непрерывный массив из Size() значений
+    template <size_t I>
+    Span<FieldType<I>> Column() noexcept {
+        return Span<FieldType<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    template <size_t I>
+    Span<const FieldType<I>> Column() const noexcept {
+        return Span<const FieldType<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    // Реаллокация всех столбцов. При исключении контейнер остаётся в прежнем состоянии
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Reallocate(new_capacity, 0, [](Columns& /*new_columns*/) {});
+        }
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack(Fields()...);
+        }
+    }
+
+    // Очистка содержимого без освобождения памяти
+    void Clear() noexcept {
+        DestroyRows(columns_, 0, size_);
+        size_ = 0;
+    }
+
+    // Добавляет строку, конструируя каждое поле из соответствующего аргумента.
+    // Аргументы могут ссылаться на элементы контейнера. Строгая гарантия безопасности
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "EmplaceBack takes one argument per field");
+        if (size_ == Capacity()) {
+            // Новая строка конструируется в новых столбцах до переноса, как в Vector
+            Reallocate(growth_.NextCapacity(Capacity(), size_ + 1, ROW_SIZE), 1, [&](Columns& new_columns) {
+                ConstructRow(new_columns, size_, Indices{}, std::forward<Args>(args)...);
+            });
+        } else {
+            ConstructRow(columns_, size_, Indices{}, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Row(size_ - 1, Indices{});
+    }
+
+    void PushBack(const value_type& row) {
+        std::apply([this](const Fields&... fields) { EmplaceBack(fields...); }, row);
+    }
+
+    void PushBack(value_type&& row) {
+        std::apply([this](Fields&... fields) { EmplaceBack(std::move(fields)...); }, row);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0 && "PopBack() called on empty vector");
+        --size_;
+        DestroyRows(columns_, size_, size_ + 1);
+    }
+
+private:
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+    // Перенос столбца нельзя откатить, если он уже разрушил исходные элементы, поэтому
+    // столбцы, перенос которых может выбросить исключение, копируются первыми
+    template <typename F>
+    static constexpr bool NOTHROW_RELOCATION = IsTriviallyRelocatableV<F> || std::is_nothrow_move_constructible_v<F>;
+
+    template <size_t... I>
+    reference Row(size_t index, std::index_sequence<I...>) const noexcept {
+        return reference(const_cast<FieldType<I>&>(std::get<I>(columns_)[index])...);
+    }
+
+    template <size_t... I>
+    void SwapColumns(SoAVector& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).Swap(std::get<I>(other.columns_)), ...);
+    }
+
+    template <size_t... I>
+    void CopyRows(const SoAVector& other, std::index_sequence<I...>) {
+        for (size_t i = 0; i < other.size_; ++i) {
+            EmplaceBack(std::get<I>(other.columns_)[i]...);
+        }
+    }
+
+    static void DestroyRows(Columns& columns, size_t first, size_t last) noexcept {
+        std::apply([first, last](auto&... column) {
+            (std::destroy(column.GetAddress() + first, column.GetAddress() + last), ...);
+        }, columns);
+    }
+
+    // Конструирует поля строки index. Если поле выбросило исключение, уже созданные поля разрушаются
+    template <size_t... I, typename... Args>
+    static void ConstructRow(Columns& columns, size_t index, std::index_sequence<I...>, Args&&... args) {
+        size_t constructed = 0;
+        VECTOR_TRY {
+            ((new (std::get<I>(columns) + index) FieldType<I>(std::forward<Args>(args)), ++constructed), ...);
+        } VECTOR_CATCH_ALL {
+            ((I < constructed ? std::destroy_at(std::get<I>(columns) + index) : void()), ...);
+            VECTOR_RETHROW;
+        }
+    }
+
+    // Создаёт столбцы вместимостью new_capacity, вызывает construct_tail(new_columns), который
+    // конструирует tail строк за size_, и переносит строки. При исключении на любом шаге
+    // исходные столбцы не меняются
+    template <typename ConstructTail>
+    void Reallocate(size_t new_capacity, size_t tail, ConstructTail&& construct_tail) {
+        Columns new_columns = AllocateColumns(new_capacity, Indices{});
+        construct_tail(new_columns);
+        VECTOR_TRY {
+            CopyThrowingColumns(new_columns, Indices{});
+        } VECTOR_CATCH_ALL {
+            DestroyRows(new_columns, size_, size_ + tail);
+            VECTOR_RETHROW;
+        }
+        RelocateColumns(new_columns, Indices{});
+        VectorStats::RecordReallocation({ROW_SIZE, Capacity(), new_capacity, size_, false});
+        SwapColumns(new_columns, Indices{});
+    }
+
+    template <size_t... I>
+    static Columns AllocateColumns(size_t capacity, std::index_sequence<I...>) {
+        return Columns(RawMemory<FieldType<I>>(capacity)...);
+    }
+
+    // Копирует в new_columns столбцы, перенос которых может выбросить исключение.
+    // При исключении разрушает уже скопированные столбцы
+    template <size_t... I>
+    void CopyThrowingColumns(Columns& new_columns, std::index_sequence<I...>) {
+        bool copied[sizeof...(Fields)] = {};
+        VECTOR_TRY {
+            ((CopyColumnIfThrowing<I>(new_columns), copied[I] = !NOTHROW_RELOCATION<FieldType<I>>), ...);
+        } VECTOR_CATCH_ALL {
+            ((copied[I] ? (void)std::destroy_n(std::get<I>(new_columns).GetAddress(), size_) : void()), ...);
+            VECTOR_RETHROW;
+        }
+    }
+
+    template <size_t I>
+    void CopyColumnIfThrowing(Columns& new_columns) {
+        using F = FieldType<I>;
+        if constexpr (!NOTHROW_RELOCATION<F>) {
+            RawMemory<F>::MoveOrCopyN(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+        }
+    }
+
+    // Завершает перенос: столбцы без исключений переносятся, у скопированных разрушаются исходные элементы
+    template <size_t... I>
+    void RelocateColumns(Columns& new_columns, std::index_sequence<I...>) noexcept {
+        (RelocateColumn<I>(new_columns), ...);
+    }
+
+    template <size_t I>
+    void RelocateColumn(Columns& new_columns) noexcept {
+        using F = FieldType<I>;
+        F* from = std::get<I>(columns_).GetAddress();
+        if constexpr (NOTHROW_RELOCATION<F>) {
+            RawMemory<F>::RelocateN(from, size_, std::get<I>(new_columns).GetAddress());
+        } else {
+            std::destroy_n(from, size_);
+        }
+    }
+
+    template <size_t... I>
+    void SwapColumns(Columns& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).Swap(std::get<I>(other)), ...);
+    }
+
+    Columns columns_;
     size_t size_ = 0;
+    [[no_unique_address]] DoublingGrowth growth_;
 };
@@ -0,0 +1,551 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+#define VECTOR_IO_POSIX 1
+#else
+#define VECTOR_IO_POSIX 0
+#endif
+
+// Двоичный формат Vector. Сообщение начинается с заголовка VectorIoHeader, за которым следует:
+//   - для тривиально копируемых T (флаг RAW) — count * element_size байт элементов подряд;
+//   - для остальных T — блоки: VectorIoChunkHeader и bytes байт, в которых закодированы
+//     count элементов через VectorCodec<T>; сумма count всех блоков равна count заголовка.
+// Числа записываются в порядке байт платформы: файл, записанный на машине с другим порядком,
+// отвергается по несовпадению magic
+inline constexpr uint32_t VECTOR_IO_MAGIC = 0x31434556;  // "VEC1"
+inline constexpr uint16_t VECTOR_IO_VERSION = 1;
+inline constexpr uint16_t VECTOR_IO_RAW = 1;
+
+struct VectorIoHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint64_t element_size;
+    uint64_t count;
+};
+
+struct VectorIoChunkHeader {
+    uint64_t bytes;
+    uint64_t count;
+};
+
+static_assert(sizeof(VectorIoHeader) == 24 && sizeof(VectorIoChunkHeader) == 16, "Unexpected header layout");
+
+// Чтение закодированных данных с проверкой границ: выход за конец блока — VectorError::FORMAT_ERROR
+class ByteReader {
+public:
+    ByteReader(const std::byte* data, size_t size) noexcept
+        : pos_(data)
+        , end_(data + size) {
+    }
+
+    size_t Remaining() const noexcept {
+        return static_cast<size_t>(end_ - pos_);
+    }
+
+    // Возвращает указатель на следующие size байт и пропускает их
+    const std::byte* Take(size_t size) {
+        if (size > Remaining()) {
+            ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: element extends past the end of chunk");
+        }
+        return std::exchange(pos_, pos_ + size);
+    }
+
+    void Read(void* to, size_t size) {
+        if (size != 0) {
+            std::memcpy(to, Take(size), size);
+        }
+    }
+
+    template <typename U>
+    U ReadValue() {
+        static_assert(std::is_trivially_copyable_v<U>, "ReadValue requires a trivially copyable type");
+        U value;
+        Read(&value, sizeof(U));
+        return value;
+    }
+
+private:
+    const std::byte* pos_;
+    const std::byte* end_;
+};
+
+namespace vector_detail {
+
+inline void AppendBytes(Vector<std::byte>& out, const void* data, size_t size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+    out.Append(bytes, bytes + size);
+}
+
+}  // namespace vector_detail
+
+// Точка настройки кодирования элементов, не являющихся тривиально копируемыми.
+// Специализация определяет
+//     static void Encode(const T& value, Vector<std::byte>& out);  // дописывает байты в out
+//     static T Decode(ByteReader& in);
+// Закодированный элемент должен занимать не меньше одного байта
+// Готовые специализации: тривиально копируемые типы, std::string и Vector из кодируемых элементов
+template <typename T, typename = void>
+struct VectorCodec;
+
+template <typename T>
+struct VectorCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+    static void Encode(const T& value, Vector<std::byte>& out) {
+        vector_detail::AppendBytes(out, &value, sizeof(T));
+    }
+
+    static T Decode(ByteReader& in) {
+        return in.ReadValue<T>();
+    }
+};
+
+template <>
+struct VectorCodec<std::string> {
+    static void Encode(const std::string& value, Vector<std::byte>& out) {
+        const uint64_t length = value.size();
+        vector_detail::AppendBytes(out, &length, sizeof(length));
+        vector_detail::AppendBytes(out, value.data(), value.size());
+    }
+
+    static std::string Decode(ByteReader& in) {
+        const auto length = in.ReadValue<uint64_t>();
+        const auto* data = reinterpret_cast<const char*>(in.Take(static_cast<size_t>(length)));
+        return std::string(data, static_cast<size_t>(length));
+    }
+};
+
+template <typename U, typename Alloc, typename Growth>
+struct VectorCodec<Vector<U, Alloc, Growth>> {
+    static void Encode(const Vector<U, Alloc, Growth>& value, Vector<std::byte>& out) {
+        const uint64_t count = value.Size();
+        vector_detail::AppendBytes(out, &count, sizeof(count));
+        for (const U& element : value) {
+            VectorCodec<U>::Encode(element, out);
+        }
+    }
+
+    static Vector<U, Alloc, Growth> Decode(ByteReader& in) {
+        const auto count = in.ReadValue<uint64_t>();
+        Vector<U, Alloc, Growth> result;
+        for (uint64_t i = 0; i < count; ++i) {
+            result.PushBack(VectorCodec<U>::Decode(in));
+        }
+        return result;
+    }
+};
+
+// Ограничения чтения данных из недоверенного источника. Размеры из заголовков не определяют
+// выделение памяти напрямую: буфер растёт по мере прихода данных
+struct VectorIoLimits {
+    static constexpr size_t DEFAULT_MAX_CHUNK_BYTES = size_t{256} << 10;
+
+    // Наибольший размер блока закодированных элементов; больший блок — VectorError::FORMAT_ERROR.
+    // Писатель закрывает блок, как только тот достигает 64 КиБ, поэтому блок превышает значение
+    // по умолчанию, только если один элемент кодируется в сотни КиБ — для таких данных его
+    // нужно увеличить
+    size_t max_chunk_bytes = DEFAULT_MAX_CHUNK_BYTES;
+    // Сообщение из не более чем trusted_count тривиально копируемых элементов читается одним
+    // Reserve и одним чтением; для больших count память выделяется окнами по мере чтения
+    uint64_t trusted_count = 0;
+};
+
+namespace vector_detail {
+
+// Размер блока, после которого закодированные элементы отправляются в приёмник
+inline constexpr size_t IO_CHUNK_BYTES = size_t{64} << 10;
+
+static_assert(VectorIoLimits::DEFAULT_MAX_CHUNK_BYTES == 4 * IO_CHUNK_BYTES);
+
+template <typename T>
+VectorIoHeader MakeIoHeader(size_t count) noexcept {
+    VectorIoHeader header{};
+    header.magic = VECTOR_IO_MAGIC;
+    header.version = VECTOR_IO_VERSION;
+    header.flags = std::is_trivially_copyable_v<T> ? VECTOR_IO_RAW : 0;
+    header.element_size = sizeof(T);
+    header.count = count;
+    return header;
+}
+
+template <typename T>
+void CheckIoHeader(const VectorIoHeader& header) {
+    if (header.magic != VECTOR_IO_MAGIC) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: bad magic");
+    }
+    if (header.version == 0 || header.version > VECTOR_IO_VERSION) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: unsupported version");
+    }
+    if ((header.flags & VECTOR_IO_RAW) != 0) {
+        if (!std::is_trivially_copyable_v<T> || header.element_size != sizeof(T)) {
+            ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: element layout mismatch");
+        }
+        if (header.count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: element count overflows size_t");
+        }
+    }
+}
+
+// Каждый элемент кодируется хотя бы одним байтом, поэтому count > bytes — признак повреждения.
+// Проверка идёт до резервирования памяти под count элементов и до чтения тела блока
+inline void CheckIoChunk(const VectorIoChunkHeader& chunk, uint64_t remaining, size_t max_chunk_bytes) {
+    if (chunk.count == 0 || chunk.count > remaining || chunk.count > chunk.bytes) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: bad chunk header");
+    }
+    if (chunk.bytes > max_chunk_bytes) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: chunk exceeds max_chunk_bytes");
+    }
+}
+
+// Резервирует место под ещё extra элементов с запасом, чтобы дописывание по частям
+// выполняло амортизированно O(1) реаллокаций на элемент
+template <typename T, typename Alloc, typename Growth>
+void ReserveForAppend(Vector<T, Alloc, Growth>& v, size_t extra) {
+    if (v.Size() + extra > v.Capacity()) {
+        v.Reserve(std::max(v.Size() + extra, v.Capacity() * 2));
+    }
+}
+
+// Дописывает в v count тривиально копируемых элементов из байтов data (выравнивание не требуется)
+template <typename T, typename Alloc, typename Growth>
+void AppendRecords(Vector<T, Alloc, Growth>& v, const std::byte* data, size_t count) {
+    ReserveForAppend(v, count);
+    const size_t old_size = v.Size();
+    v.ResizeDefaultInit(old_size + count);
+    if (count != 0) {
+        std::memcpy(static_cast<void*>(v.begin() + old_size), data, count * sizeof(T));
+    }
+}
+
+// Декодирует блок из count элементов и дописывает их в v
+template <typename T, typename Alloc, typename Growth>
+void DecodeIoChunk(Vector<T, Alloc, Growth>& v, const std::byte* data, size_t bytes, size_t count) {
+    ByteReader reader(data, bytes);
+    ReserveForAppend(v, count);
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(VectorCodec<T>::Decode(reader));
+    }
+    if (reader.Remaining() != 0) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: trailing bytes in chunk");
+    }
+}
+
+#if VECTOR_IO_POSIX
+inline void WriteAll(int fd, const void* first, size_t first_size, const void* second = nullptr,
+                     size_t second_size = 0) {
+    // Оба блока уходят одним writev; при частичной записи остаток дописывается
+    iovec parts[2] = {{const_cast<void*>(first), first_size}, {const_cast<void*>(second), second_size}};
+    iovec* part = parts;
+    int count = second_size != 0 ? 2 : 1;
+    while (count > 0) {
+        const ssize_t written = writev(fd, part, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ReportVectorError(VectorError::SYSTEM_ERROR, "VectorIo: write failed");
+        }
+        size_t rest = static_cast<size_t>(written);
+        while (count > 0 && rest >= part->iov_len) {
+            rest -= part->iov_len;
+            ++part;
+            --count;
+        }
+        if (count > 0) {
+            part->iov_base = static_cast<char*>(part->iov_base) + rest;
+            part->iov_len -= rest;
+        }
+    }
+}
+
+// Читает ровно size байт. Возвращает false, если данные закончились раньше
+inline bool ReadExact(int fd, void* to, size_t size) {
+    auto* bytes = static_cast<char*>(to);
+    while (size > 0) {
+        const ssize_t received = read(fd, bytes, size);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ReportVectorError(VectorError::SYSTEM_ERROR, "VectorIo: read failed");
+        }
+        if (received == 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+#endif
+
+inline void WriteAll(std::ostream& out, const void* first, size_t first_size, const void* second = nullptr,
+                     size_t second_size = 0) {
+    out.write(static_cast<const char*>(first), static_cast<std::streamsize>(first_size));
+    if (second_size != 0) {
+        out.write(static_cast<const char*>(second), static_cast<std::streamsize>(second_size));
+    }
+    if (!out) {
+        errno = EIO;
+        ReportVectorError(VectorError::SYSTEM_ERROR, "VectorIo: stream write failed");
+    }
+}
+
+inline bool ReadExact(std::istream& in, void* to, size_t size) {
+    in.read(static_cast<char*>(to), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(in.gcount()) == size) {
+        return true;
+    }
+    if (in.bad()) {
+        errno = EIO;
+        ReportVectorError(VectorError::SYSTEM_ERROR, "VectorIo: stream read failed");
+    }
+    return false;
+}
+
+template <typename In>
+void ReadOrFail(In& in, void* to, size_t size) {
+    if (!ReadExact(in, to, size)) {
+        ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: unexpected end of data");
+    }
+}
+
+template <typename Out, typename T, typename Alloc, typename Growth>
+void WriteVector(Out& out, const Vector<T, Alloc, Growth>& v) {
+    const VectorIoHeader header = MakeIoHeader<T>(v.Size());
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        WriteAll(out, &header, sizeof(header), v.begin(), v.Size() * sizeof(T));
+    } else {
+        WriteAll(out, &header, sizeof(header));
+        // Заголовок блока записывается в начало буфера, чтобы блок уходил одной записью
+        Vector<std::byte> chunk;
+        chunk.Reserve(IO_CHUNK_BYTES + sizeof(VectorIoChunkHeader));
+        chunk.Resize(sizeof(VectorIoChunkHeader));
+        size_t chunk_count = 0;
+        const auto flush = [&] {
+            const VectorIoChunkHeader chunk_header{chunk.Size() - sizeof(VectorIoChunkHeader), chunk_count};
+            std::memcpy(chunk.begin(), &chunk_header, sizeof(chunk_header));
+            WriteAll(out, chunk.begin(), chunk.Size());
+            chunk.Resize(sizeof(VectorIoChunkHeader));
+            chunk_count = 0;
+        };
+        for (const T& value : v) {
+            VectorCodec<T>::Encode(value, chunk);
+            ++chunk_count;
+            if (chunk.Size() >= IO_CHUNK_BYTES) {
+                flush();
+            }
+        }
+        if (chunk_count != 0) {
+            flush();
+        }
+    }
+}
+
+// Читает count тривиально копируемых элементов прямо в буфер v. Вместимость растёт
+// геометрически, окнами не меньше IO_CHUNK_BYTES, и не превышает count, поэтому выделенная память
+// не более чем вдвое больше уже прочитанной плюс одно окно
+template <typename In, typename T, typename Alloc, typename Growth>
+void ReadRecords(In& in, Vector<T, Alloc, Growth>& v, size_t count) {
+    const size_t window = std::max<size_t>(IO_CHUNK_BYTES / sizeof(T), 1);
+    while (v.Size() < count) {
+        const size_t old_size = v.Size();
+        const size_t new_size = std::min(count, std::max(old_size + window, v.Capacity() * 2));
+        v.Reserve(new_size);
+        v.ResizeDefaultInit(new_size);
+        if (!ReadExact(in, v.begin() + old_size, (new_size - old_size) * sizeof(T))) {
+            v.Clear();
+            ReportVectorError(VectorError::FORMAT_ERROR, "VectorIo: unexpected end of data");
+        }
+    }
+}
+
+template <typename In, typename T, typename Alloc, typename Growth>
+void ReadVector(In& in, Vector<T, Alloc, Growth>& v, const VectorIoLimits& limits) {
+    VectorIoHeader header;
+    ReadOrFail(in, &header, sizeof(header));
+    CheckIoHeader<T>(header);
+    v.Clear();
+    if ((header.flags & VECTOR_IO_RAW) != 0) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const auto count = static_cast<size_t>(header.count);
+            if (header.count <= limits.trusted_count) {
+                // Одна аллокация и одно чтение прямо в буфер вектора
+                v.Reserve(count);
+            }
+            ReadRecords(in, v, count);
+        }
+        return;
+    }
+    Vector<std::byte> chunk;
+    for (uint64_t remaining = header.count; remaining > 0;) {
+        VectorIoChunkHeader chunk_header;
+        ReadOrFail(in, &chunk_header, sizeof(chunk_header));
+        CheckIoChunk(chunk_header, remaining, limits.max_chunk_bytes);
+        // Тело читается частями по IO_CHUNK_BYTES: буфер растёт, только пока данные приходят
+        const auto bytes = static_cast<size_t>(chunk_header.bytes);
+        chunk.Clear();
+        while (chunk.Size() < bytes) {
+            const size_t old_size = chunk.Size();
+            chunk.ResizeUninitialized(old_size + std::min(bytes - old_size, IO_CHUNK_BYTES));
+            ReadOrFail(in, chunk.begin() + old_size, chunk.Size() - old_size);
+        }
+        DecodeIoChunk(v, chunk.begin(), chunk.Size(), static_cast<size_t>(chunk_header.count));
+        remaining -= chunk_header.count;
+    }
+}
+
+}  // namespace vector_detail
+
+// Запись и чтение Vector в двоичном формате (см. VectorIoHeader). Тривиально копируемые элементы
+// пишутся одним writev вместе с заголовком и читаются прямо в буфер без поэлементной работы:
+// окнами по мере прихода данных либо, если count не больше limits.trusted_count, одним Reserve
+// и одним чтением. Остальные кодируются VectorCodec<T> блоками по IO_CHUNK_BYTES.
+// ReadFrom заменяет содержимое вектора; при ошибке (VectorError::FORMAT_ERROR для повреждённых
+// данных и нарушения limits, SYSTEM_ERROR для отказа ввода-вывода) содержимое вектора не определено
+#if VECTOR_IO_POSIX
+template <typename T, typename Alloc, typename Growth>
+void WriteTo(const Vector<T, Alloc, Growth>& v, int fd) {
+    vector_detail::WriteVector(fd, v);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void ReadFrom(Vector<T, Alloc, Growth>& v, int fd, const VectorIoLimits& limits = {}) {
+    vector_detail::ReadVector(fd, v, limits);
+}
+#endif
+
+template <typename T, typename Alloc, typename Growth>
+void WriteTo(const Vector<T, Alloc, Growth>& v, std::ostream& out) {
+    vector_detail::WriteVector(out, v);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void ReadFrom(Vector<T, Alloc, Growth>& v, std::istream& in, const VectorIoLimits& limits = {}) {
+    vector_detail::ReadVector(in, v, limits);
+}
+
+// Инкрементальное чтение сообщения, приходящего по частям (например, из неблокирующего сокета).
+// Feed дописывает в целевой вектор каждый полностью полученный элемент, не дожидаясь конца
+// сообщения. Неполный хвост порции сохраняется до следующего вызова, поэтому буфер читателя
+// не превышает limits.max_chunk_bytes. После ошибки формата состояние читателя не определено
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class VectorReader {
+public:
+    explicit VectorReader(Vector<T, Alloc, Growth>& target, const VectorIoLimits& limits = {}) noexcept
+        : target_(&target)
+        , limits_(limits) {
+    }
+
+    // Принимает очередную порцию байтов. Возвращает число использованных байтов: оно меньше size,
+    // только если сообщение закончилось и остальные байты относятся к следующему
+    size_t Feed(const void* data, size_t size) {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        const size_t total = size;
+        const std::byte* block = nullptr;
+        while (state_ != State::DONE) {
+            switch (state_) {
+                case State::HEADER: {
+                    if (!Take(bytes, size, sizeof(VectorIoHeader), block)) {
+                        return total;
+                    }
+                    VectorIoHeader header;
+                    std::memcpy(&header, block, sizeof(header));
+                    pending_.Clear();
+                    vector_detail::CheckIoHeader<T>(header);
+                    remaining_ = header.count;
+                    state_ = (header.flags & VECTOR_IO_RAW) != 0 ? State::RAW : State::CHUNK_HEADER;
+                    break;
+                }
+                case State::CHUNK_HEADER:
+                    if (!Take(bytes, size, sizeof(VectorIoChunkHeader), block)) {
+                        return total;
+                    }
+                    std::memcpy(&chunk_, block, sizeof(chunk_));
+                    pending_.Clear();
+                    vector_detail::CheckIoChunk(chunk_, remaining_, limits_.max_chunk_bytes);
+                    state_ = State::CHUNK_BODY;
+                    break;
+                case State::CHUNK_BODY:
+                    if (!Take(bytes, size, static_cast<size_t>(chunk_.bytes), block)) {
+                        return total;
+                    }
+                    vector_detail::DecodeIoChunk(*target_, block, static_cast<size_t>(chunk_.bytes),
+                                                 static_cast<size_t>(chunk_.count));
+                    pending_.Clear();
+                    remaining_ -= chunk_.count;
+                    state_ = State::CHUNK_HEADER;
+                    break;
+                case State::RAW:
+                    if constexpr (std::is_trivially_copyable_v<T>) {
+                        if (!pending_.Empty() || size < sizeof(T)) {
+                            // Запись, разрезанная между порциями, собирается в pending_
+                            if (!Take(bytes, size, sizeof(T), block)) {
+                                return total;
+                            }
+                            vector_detail::AppendRecords(*target_, block, 1);
+                            pending_.Clear();
+                            --remaining_;
+                        } else {
+                            const auto count = static_cast<size_t>(std::min<uint64_t>(size / sizeof(T), remaining_));
+                            vector_detail::AppendRecords(*target_, bytes, count);
+                            bytes += count * sizeof(T);
+                            size -= count * sizeof(T);
+                            remaining_ -= count;
+                        }
+                    }
+                    break;
+                case State::DONE:
+                    break;
+            }
+            if (remaining_ == 0 && state_ != State::HEADER) {
+                state_ = State::DONE;
+            }
+        }
+        return total - size;
+    }
+
+    // Истина, если сообщение прочитано полностью
+    bool Done() const noexcept {
+        return state_ == State::DONE;
+    }
+
+private:
+    enum class State { HEADER, RAW, CHUNK_HEADER, CHUNK_BODY, DONE };
+
+    // Находит need подряд идущих байтов: прямо во входной порции или, если они приходят по частям,
+    // в pending_. Возвращает false, если байтов пока недостаточно (все доступные сохранены)
+    bool Take(const std::byte*& data, size_t& size, size_t need, const std::byte*& block) {
+        if (pending_.Empty() && size >= need) {
+            block = data;
+            data += need;
+            size -= need;
+            return true;
+        }
+        const size_t portion = std::min(size, need - pending_.Size());
+        pending_.Append(data, data + portion);
+        data += portion;
+        size -= portion;
+        block = pending_.begin();
+        return pending_.Size() == need;
+    }
+
+    Vector<T, Alloc, Growth>* target_;
+    VectorIoLimits limits_;
+    // Байты заголовка, блока или записи, пришедших не целиком
+    Vector<std::byte> pending_;
+    State state_ = State::HEADER;
+    // Сколько элементов сообщения ещё не получено
+    uint64_t remaining_ = 0;
+    VectorIoChunkHeader chunk_{};
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#if defined(VECTOR_ENABLE_STATS)
+#include <atomic>
+#endif
+
+// Снимок глобальной статистики RawMemory/Vector. Байты считаются по sizeof(T) * вместимость
+struct VectorStatsSnapshot {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_deallocated = 0;
+    // Смены буфера вектора с переносом элементов, включая изменение блока средствами аллокатора
+    uint64_t reallocations = 0;
+    // Элементы, перенесённые при реаллокации: перемещением, копированием и побайтово
+    uint64_t elements_moved = 0;
+    uint64_t elements_copied = 0;
+    uint64_t elements_relocated_bitwise = 0;
+    // Наибольший блок и наибольший суммарный объём одновременно выделенной памяти
+    uint64_t peak_capacity_bytes = 0;
+    uint64_t peak_live_bytes = 0;
+    // Неиспользованная вместимость буферов в момент их освобождения или замены вектором
+    uint64_t wasted_capacity_bytes = 0;
+    // Объём памяти, выделенной и ещё не освобождённой
+    uint64_t live_bytes = 0;
+    // Выделения RecyclingAllocator (allocators.h): блок взят из кеша потока или из кучи
+    uint64_t recycle_hits = 0;
+    uint64_t recycle_misses = 0;
+};
+
+// Событие смены буфера, передаётся обработчику, установленному через SetReallocationCallback
+struct VectorReallocationEvent {
+    size_t element_size;
+    size_t old_capacity;
+    size_t new_capacity;
+    size_t size;
+    // true, если блок изменён аллокатором без переноса элементов (см. HasReallocate)
+    bool in_place;
+};
+
+// Статистика выделений памяти и переносов элементов для всех векторов программы.
+// Включается определением VECTOR_ENABLE_STATS до подключения vector.h; без него все методы
+// Record* пусты и встраиваются в ничто, Snapshot() возвращает нули, а обработчик не вызывается.
+// Счётчики атомарны и общие для всех потоков. Обработчик вызывается синхронно в потоке,
+// выполняющем реаллокацию, и не должен выбрасывать исключений
+class VectorStats {
+public:
+    using ReallocationCallback = void (*)(const VectorReallocationEvent& event, void* context) noexcept;
+
+    static VectorStatsSnapshot Snapshot() noexcept {
+        VectorStatsSnapshot result;
+#if defined(VECTOR_ENABLE_STATS)
+        const Counters& c = Get();
+        result.allocations = c.allocations.load(std::memory_order_relaxed);
+        result.deallocations = c.deallocations.load(std::memory_order_relaxed);
+        result.bytes_allocated = c.bytes_allocated.load(std::memory_order_relaxed);
+        result.bytes_deallocated = c.bytes_deallocated.load(std::memory_order_relaxed);
+        result.reallocations = c.reallocations.load(std::memory_order_relaxed);
+        result.elements_moved = c.elements_moved.load(std::memory_order_relaxed);
+        result.elements_copied = c.elements_copied.load(std::memory_order_relaxed);
+        result.elements_relocated_bitwise = c.elements_relocated_bitwise.load(std::memory_order_relaxed);
+        result.peak_capacity_bytes = c.peak_capacity_bytes.load(std::memory_order_relaxed);
+        result.peak_live_bytes = c.peak_live_bytes.load(std::memory_order_relaxed);
+        result.wasted_capacity_bytes = c.wasted_capacity_bytes.load(std::memory_order_relaxed);
+        result.live_bytes = c.live_bytes.load(std::memory_order_relaxed);
+        result.recycle_hits = c.recycle_hits.load(std::memory_order_relaxed);
+        result.recycle_misses = c.recycle_misses.load(std::memory_order_relaxed);
+#endif
+        return result;
+    }
+
+    // Обнуляет счётчики. Объём живой памяти сохраняется, а его пик становится равным текущему объёму
+    static void Reset() noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Counters& c = Get();
+        for (std::atomic<uint64_t>* counter :
+             {&c.allocations, &c.deallocations, &c.bytes_allocated, &c.bytes_deallocated, &c.reallocations,
+              &c.elements_moved, &c.elements_copied, &c.elements_relocated_bitwise, &c.peak_capacity_bytes,
+              &c.wasted_capacity_bytes, &c.recycle_hits, &c.recycle_misses}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        c.peak_live_bytes.store(c.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+    }
+
+    // Устанавливает обработчик событий реаллокации (nullptr отключает его), например для
+    // выгрузки метрик или записи стека вызовов при «шторме» реаллокаций
+    static void SetReallocationCallback([[maybe_unused]] ReallocationCallback callback,
+                                        [[maybe_unused]] void* context = nullptr) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Counters& c = Get();
+        c.callback_context.store(context, std::memory_order_relaxed);
+        c.callback.store(callback, std::memory_order_release);
+#endif
+    }
+
+    static constexpr bool Enabled() noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Точки учёта, вызываемые RawMemory и Vector
+    static void RecordAllocation([[maybe_unused]] size_t bytes) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Counters& c = Get();
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        UpdateMax(c.peak_capacity_bytes, bytes);
+        UpdateMax(c.peak_live_bytes, c.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+#endif
+    }
+
+    static void RecordDeallocation([[maybe_unused]] size_t bytes) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Counters& c = Get();
+        c.deallocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+        c.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+#endif
+    }
+
+    // Изменение блока аллокатором на месте учитывается как освобождение старого и выделение нового
+    static void RecordBlockResize(size_t old_bytes, size_t new_bytes) noexcept {
+        RecordDeallocation(old_bytes);
+        RecordAllocation(new_bytes);
+    }
+
+    static void RecordMoved([[maybe_unused]] size_t count) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().elements_moved.fetch_add(count, std::memory_order_relaxed);
+#endif
+    }
+
+    static void RecordCopied([[maybe_unused]] size_t count) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().elements_copied.fetch_add(count, std::memory_order_relaxed);
+#endif
+    }
+
+    static void RecordRelocatedBitwise([[maybe_unused]] size_t count) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().elements_relocated_bitwise.fetch_add(count, std::memory_order_relaxed);
+#endif
+    }
+
+    // Вызывается вектором, освобождающим или заменяющим буфер с size элементами
+    static void RecordRelease([[maybe_unused]] size_t element_size, [[maybe_unused]] size_t capacity,
+                              [[maybe_unused]] size_t size) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().wasted_capacity_bytes.fetch_add((capacity - size) * element_size, std::memory_order_relaxed);
+#endif
+    }
+
+    // Вызываются RecyclingAllocator: блок выдан из кеша потока либо кеш был пуст
+    static void RecordRecycleHit() noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().recycle_hits.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    static void RecordRecycleMiss() noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Get().recycle_misses.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    static void RecordReallocation([[maybe_unused]] const VectorReallocationEvent& event) noexcept {
+#if defined(VECTOR_ENABLE_STATS)
+        Counters& c = Get();
+        c.reallocations.fetch_add(1, std::memory_order_relaxed);
+        RecordRelease(event.element_size, event.old_capacity, event.size);
+        if (ReallocationCallback callback = c.callback.load(std::memory_order_acquire)) {
+            callback(event, c.callback_context.load(std::memory_order_relaxed));
+        }
+#endif
+    }
+
+private:
+#if defined(VECTOR_ENABLE_STATS)
+    struct Counters {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<uint64_t> bytes_deallocated{0};
+        std::atomic<uint64_t> reallocations{0};
+        std::atomic<uint64_t> elements_moved{0};
+        std::atomic<uint64_t> elements_copied{0};
+        std::atomic<uint64_t> elements_relocated_bitwise{0};
+        std::atomic<uint64_t> peak_capacity_bytes{0};
+        std::atomic<uint64_t> peak_live_bytes{0};
+        std::atomic<uint64_t> wasted_capacity_bytes{0};
+        std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> recycle_hits{0};
+        std::atomic<uint64_t> recycle_misses{0};
+        std::atomic<ReallocationCallback> callback{nullptr};
+        std::atomic<void*> callback_context{nullptr};
+    };
+
+    // Единственный экземпляр на программу: inline-функция со статической переменной
+    static Counters& Get() noexcept {
+        static Counters counters;
+        return counters;
+    }
+
+    static void UpdateMax(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+#endif
+};